@@ -0,0 +1,89 @@
+#pragma once
+
+#if defined _WIN32 || defined __CYGWIN__
+  #ifdef BUILDING_CSPARALLEL_DLL
+    #define CS_PARALLEL_TASK_API __declspec(dllexport)
+  #else
+    #define CS_PARALLEL_TASK_API __declspec(dllimport)
+  #endif
+#else
+  #ifdef BUILDING_CSPARALLEL_DLL
+    #define CS_PARALLEL_TASK_API __attribute__ ((visibility ("default")))
+  #else
+    #define CS_PARALLEL_TASK_API
+  #endif
+#endif
+
+#ifndef CSAFFINITY_H_INCLUDED
+#define CSAFFINITY_H_INCLUDED
+
+#include <cstddef>
+#include <vector>
+#include <thread>
+
+#define CSAFFINITY_NONE       0
+#define CSAFFINITY_COMPACT    1
+#define CSAFFINITY_SCATTER    2
+#define CSAFFINITY_LIST       3
+#define CSAFFINITY_NUMA       4
+
+// Variable d'environnement qui impose le nombre de threads
+#define CSPARALLEL_THREADS_ENV  "CSPARALLEL_NUM_THREADS"
+
+namespace csParallelTask
+{
+
+/**
+ * @brief Returns the CPUs the process is allowed to run on (sched_getaffinity on Linux, all the hardware threads elsewhere).
+ * @return Sorted list of CPU numbers.
+ */
+std::vector<size_t> getAvailableCpus();
+/**
+ * @brief Returns the CPU quota of the process in CPUs, rounded up, from the cgroup v2 cpu.max or cgroup v1 cpu.cfs_quota_us / cpu.cfs_period_us
+ * files of its cgroup and of its parents (the smallest quota applies).
+ * @return Number of CPUs allowed by the quota, or 0 if there is no quota.
+ */
+size_t getCpuQuota();
+/**
+ * @brief Returns the number of threads the process can really run at the same time: the value of the CSPARALLEL_NUM_THREADS environment variable
+ * if it is set, otherwise the number of CPUs in the affinity mask limited by the cgroup CPU quota. Computed once.
+ * @return Number of threads, at least 1.
+ */
+size_t getAvailableConcurrency();
+/**
+ * @brief Returns the number of NUMA nodes of the machine (1 if the topology is unknown).
+ * @return Number of NUMA nodes.
+ */
+size_t getNumaNodeNumber();
+/**
+ * @brief Returns the NUMA node of the CPU @p cpu (0 if the topology is unknown).
+ * @param cpu CPU number.
+ * @return NUMA node of the CPU.
+ */
+size_t getCpuNode(size_t cpu);
+/**
+ * @brief Orders the available CPUs following an affinity policy.
+ * CSAFFINITY_COMPACT: node by node, the hyper-threads of a core next to each other, so that consecutive threads share caches.
+ * CSAFFINITY_SCATTER: round-robin over the NUMA nodes, one hyper-thread per core first, so that consecutive threads use separate nodes and cores.
+ * @param policy CSAFFINITY_COMPACT or CSAFFINITY_SCATTER; any other value returns getAvailableCpus().
+ * @return Ordered list of CPU numbers.
+ */
+std::vector<size_t> getCpuOrder(int policy);
+/**
+ * @brief Binds the thread @p thread to the CPU @p cpu. Does nothing on systems without thread affinity support.
+ * @param thread Native handle of the thread.
+ * @param cpu CPU number.
+ * @return true if the thread has been bound.
+ */
+bool pinThread(std::thread::native_handle_type thread, size_t cpu);
+/**
+ * @brief Allows the thread @p thread to run on any CPU of @p cpus.
+ * @param thread Native handle of the thread.
+ * @param cpus List of CPU numbers.
+ * @return true if the affinity has been changed.
+ */
+bool pinThread(std::thread::native_handle_type thread, const std::vector<size_t>& cpus);
+
+}
+
+#endif // CSAFFINITY_H_INCLUDED
@@ -0,0 +1,445 @@
+#pragma once
+
+#if defined _WIN32 || defined __CYGWIN__
+  #ifdef BUILDING_CSPARALLEL_DLL
+    #define CS_PARALLEL_TASK_API __declspec(dllexport)
+  #else
+    #define CS_PARALLEL_TASK_API __declspec(dllimport)
+  #endif
+#else
+  #ifdef BUILDING_CSPARALLEL_DLL
+    #define CS_PARALLEL_TASK_API __attribute__ ((visibility ("default")))
+  #else
+    #define CS_PARALLEL_TASK_API
+  #endif
+#endif
+
+#ifndef CSALGORITHM_H_INCLUDED
+#define CSALGORITHM_H_INCLUDED
+
+#include <cstddef>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <iterator>
+#include <functional>
+#include "csParallel.h"
+
+// Nombre minimal d'elements par tache : en dessous, la boucle est executee sur le thread appelant
+#define CSALGORITHM_GRAIN  4096
+// Nombre de morceaux par tache pour parallel_for : assez pour equilibrer, assez peu pour limiter les acces au compteur
+#define CSALGORITHM_CHUNKS_PER_TASK  8
+
+namespace csParallelTask
+{
+
+/**
+ * @brief Returns the number of pool tasks used to process @p n elements with at least @p grain elements per task.
+ * @param n Number of elements.
+ * @param grain Minimal number of elements per task.
+ * @return Number of tasks, between 1 and the number of workers + 1 (the caller also works).
+ */
+inline size_t getAlgorithmTaskNumber(size_t n, size_t grain)
+{
+    size_t maxTasks = getThreadPool()->getWorkerNumber() + 1;
+    grain = std::max((size_t)1, grain);
+    return std::max((size_t)1, std::min(maxTasks, (n + grain - 1)/grain));
+};
+
+// Resultat partiel d'une tache, seul sur sa ligne de cache
+template<class T> struct alignas(64) CSALGORITHM_PARTIAL
+{
+    T value;
+};
+
+template<class F> class CSFOR_CONTEXT
+{
+public:
+    CSFOR_CONTEXT(size_t first, size_t last, size_t chunk, F& body) : last(last), chunk(chunk), body(body)
+    {
+        next = first;
+    };
+
+    // Chaque tache prend des morceaux au compteur partage jusqu'a epuisement de l'intervalle
+    static void run(void* ctx, size_t)
+    {
+        CSFOR_CONTEXT<F>* c = (CSFOR_CONTEXT<F>*)ctx;
+        size_t first;
+        while ((first = c->next.fetch_add(c->chunk, std::memory_order_relaxed)) < c->last)
+        {
+            size_t last = std::min(first + c->chunk, c->last);
+            for(size_t i=first; i<last; i++)
+                c->body(i);
+        }
+    };
+
+    alignas(64) std::atomic<size_t> next;
+    size_t last;
+    size_t chunk;
+    F& body;
+};
+
+template<class T, class F, class C> class CSREDUCE_CONTEXT
+{
+public:
+    CSREDUCE_CONTEXT(size_t first, size_t last, size_t nTasks, T identity, F& body, C& combine)
+        : first(first), last(last), nTasks(nTasks), identity(identity), body(body), combine(combine), partials(nTasks)
+    {
+    };
+
+    // Decoupage statique et contigu : le resultat ne depend pas de l'ordre d'execution des taches
+    static void run(void* ctx, size_t task)
+    {
+        CSREDUCE_CONTEXT<T,F,C>* c = (CSREDUCE_CONTEXT<T,F,C>*)ctx;
+        size_t n = c->last - c->first;
+        size_t first = c->first + task*n/c->nTasks;
+        size_t last = c->first + (task+1)*n/c->nTasks;
+        T acc = c->identity;
+        for(size_t i=first; i<last; i++)
+            acc = c->combine(acc, c->body(i));
+        c->partials[task].value = acc;
+    };
+
+    size_t first;
+    size_t last;
+    size_t nTasks;
+    T identity;
+    F& body;
+    C& combine;
+    std::vector<CSALGORITHM_PARTIAL<T>> partials;
+};
+
+/**
+ * @brief Calls @p body(i) for every i in [@p first, @p last) on the shared worker pool, without registering a function.
+ * The interval is cut into chunks taken from a shared counter, so uneven iterations are balanced between the workers.
+ * The calling thread takes part in the loop; a call made from a worker is nested on the same pool.
+ * @param first First index.
+ * @param last Index following the last one.
+ * @param body Callable taking a size_t index.
+ * @param grain Minimal number of iterations per task (and per chunk).
+ */
+template<class F> void parallel_for(size_t first, size_t last, F body, size_t grain = CSALGORITHM_GRAIN)
+{
+    if (first >= last)
+        return;
+
+    size_t n = last - first;
+    size_t nTasks = getAlgorithmTaskNumber(n, grain);
+    if (nTasks == 1)
+    {
+        for(size_t i=first; i<last; i++)
+            body(i);
+        return;
+    }
+
+    size_t chunk = std::max(std::max((size_t)1, grain), n/(nTasks*CSALGORITHM_CHUNKS_PER_TASK));
+    CSFOR_CONTEXT<F> ctx(first, last, chunk, body);
+    getThreadPool()->run(nTasks, CSFOR_CONTEXT<F>::run, &ctx);
+};
+/**
+ * @brief Same as parallel_for(first, last, body, grain) on the interval @p range.
+ * @param range Interval [first, last).
+ * @param body Callable taking a size_t index.
+ * @param grain Minimal number of iterations per task.
+ */
+template<class F> void parallel_for(CSPARGS::BOUNDS range, F body, size_t grain = CSALGORITHM_GRAIN)
+{
+    parallel_for(range.first, range.last, body, grain);
+};
+/**
+ * @brief Reduces body(i) for every i in [@p first, @p last) with @p combine on the shared worker pool.
+ * Each task reduces one contiguous part of the interval into a cache-line-padded partial result, and the partials are combined
+ * pairwise on the calling thread. For a given number of workers the order of the operations is fixed, so the result is reproducible.
+ * @param first First index.
+ * @param last Index following the last one.
+ * @param identity Neutral element of @p combine.
+ * @param body Callable taking a size_t index and returning the value of the element.
+ * @param combine Associative callable combining two values.
+ * @param grain Minimal number of elements per task.
+ * @return Reduced value, or @p identity for an empty interval.
+ */
+template<class T, class F, class C> T parallel_reduce(size_t first, size_t last, T identity, F body, C combine, size_t grain = CSALGORITHM_GRAIN)
+{
+    if (first >= last)
+        return identity;
+
+    size_t nTasks = getAlgorithmTaskNumber(last - first, grain);
+    CSREDUCE_CONTEXT<T,F,C> ctx(first, last, nTasks, identity, body, combine);
+    if (nTasks == 1)
+        CSREDUCE_CONTEXT<T,F,C>::run(&ctx, 0);
+    else
+        getThreadPool()->run(nTasks, CSREDUCE_CONTEXT<T,F,C>::run, &ctx);
+
+    for(size_t stride=1; stride<nTasks; stride*=2)
+    {
+        for(size_t i=0; i+stride<nTasks; i+=2*stride)
+            ctx.partials[i].value = combine(ctx.partials[i].value, ctx.partials[i+stride].value);
+    }
+    return ctx.partials[0].value;
+};
+/**
+ * @brief Same as parallel_reduce(first, last, identity, body, combine, grain) on the interval @p range.
+ */
+template<class T, class F, class C> T parallel_reduce(CSPARGS::BOUNDS range, T identity, F body, C combine, size_t grain = CSALGORITHM_GRAIN)
+{
+    return parallel_reduce(range.first, range.last, identity, body, combine, grain);
+};
+/**
+ * @brief Parallel std::transform: writes op(first[i]) to out[i] for every element of [@p first, @p last).
+ * @param first Random-access iterator (or pointer) to the first input element.
+ * @param last Iterator following the last input element.
+ * @param out Random-access iterator to the first output element. May be equal to @p first.
+ * @param op Callable applied to each element.
+ * @return Iterator following the last output element.
+ */
+template<class InIt, class OutIt, class F> OutIt parallel_transform(InIt first, InIt last, OutIt out, F op)
+{
+    size_t n = last - first;
+    parallel_for((size_t)0, n, [&](size_t i){ out[i] = op(first[i]); });
+    return out + n;
+};
+/**
+ * @brief Parallel binary std::transform: writes op(first1[i], first2[i]) to out[i] for every element of [@p first1, @p last1).
+ * @param first1 Random-access iterator to the first element of the first input.
+ * @param last1 Iterator following the last element of the first input.
+ * @param first2 Random-access iterator to the first element of the second input.
+ * @param out Random-access iterator to the first output element. May be equal to @p first1 or @p first2.
+ * @param op Callable applied to each pair of elements.
+ * @return Iterator following the last output element.
+ */
+template<class InIt1, class InIt2, class OutIt, class F> OutIt parallel_transform(InIt1 first1, InIt1 last1, InIt2 first2, OutIt out, F op)
+{
+    size_t n = last1 - first1;
+    parallel_for((size_t)0, n, [&](size_t i){ out[i] = op(first1[i], first2[i]); });
+    return out + n;
+};
+/**
+ * @brief Two-pass parallel scan of [@p first, @p last) into @p out. Used by the inclusive and exclusive scans.
+ * The range is cut into one contiguous part per task. Pass 1 reduces each part; the part totals are scanned on the calling thread,
+ * which gives the offset of every part; pass 2 scans each part from its offset.
+ * @param first Random-access iterator to the first input element.
+ * @param last Iterator following the last input element.
+ * @param out Random-access iterator to the first output element. May be equal to @p first.
+ * @param init Value combined before the first element.
+ * @param op Associative operator.
+ * @param inclusive true if out[i] includes first[i], false if it covers the elements before i only.
+ * @param grain Minimal number of elements per task.
+ * @return Iterator following the last output element.
+ */
+template<class InIt, class OutIt, class T, class Op> OutIt parallel_scan(InIt first, InIt last, OutIt out, T init, Op op, bool inclusive, size_t grain = CSALGORITHM_GRAIN)
+{
+    size_t n = last - first;
+    size_t nParts = getAlgorithmTaskNumber(n, grain);
+    auto scanPart = [&](size_t a, size_t b, T acc)
+    {
+        for(size_t i=a; i<b; i++)
+        {
+            // Lecture avant l'ecriture : out peut etre egal a first
+            T v = first[i];
+            if (inclusive)
+            {
+                acc = op(acc, v);
+                out[i] = acc;
+            }
+            else
+            {
+                out[i] = acc;
+                acc = op(acc, v);
+            }
+        }
+    };
+    if (nParts == 1)
+    {
+        scanPart(0, n, init);
+        return out + n;
+    }
+
+    std::vector<CSALGORITHM_PARTIAL<T>> partials(nParts);
+    parallel_for(0, nParts, [&](size_t p)
+    {
+        size_t a = p*n/nParts, b = (p+1)*n/nParts;
+        T acc = first[a];
+        for(size_t i=a+1; i<b; i++)
+            acc = op(acc, first[i]);
+        partials[p].value = acc;
+    }, 1);
+
+    T offset = init;
+    for(size_t p=0; p<nParts; p++)
+    {
+        T total = partials[p].value;
+        partials[p].value = offset;
+        offset = op(offset, total);
+    }
+
+    parallel_for(0, nParts, [&](size_t p)
+    {
+        scanPart(p*n/nParts, (p+1)*n/nParts, partials[p].value);
+    }, 1);
+    return out + n;
+};
+/**
+ * @brief Parallel std::inclusive_scan: out[i] = init op first[0] op ... op first[i].
+ * @param first Random-access iterator to the first input element.
+ * @param last Iterator following the last input element.
+ * @param out Random-access iterator to the first output element. May be equal to @p first.
+ * @param op Associative operator.
+ * @param init Value combined before the first element (the identity of @p op for a plain scan).
+ * @return Iterator following the last output element.
+ */
+template<class InIt, class OutIt, class Op, class T> OutIt parallel_inclusive_scan(InIt first, InIt last, OutIt out, Op op, T init)
+{
+    return parallel_scan(first, last, out, init, op, true);
+};
+/**
+ * @brief Parallel prefix sum: out[i] = first[0] + ... + first[i].
+ * @param first Random-access iterator to the first input element.
+ * @param last Iterator following the last input element.
+ * @param out Random-access iterator to the first output element. May be equal to @p first.
+ * @return Iterator following the last output element.
+ */
+template<class InIt, class OutIt> OutIt parallel_inclusive_scan(InIt first, InIt last, OutIt out)
+{
+    typedef typename std::iterator_traits<InIt>::value_type T;
+    return parallel_scan(first, last, out, T(), std::plus<T>(), true);
+};
+/**
+ * @brief Parallel std::exclusive_scan: out[0] = init, out[i] = init op first[0] op ... op first[i-1].
+ * @param first Random-access iterator to the first input element.
+ * @param last Iterator following the last input element.
+ * @param out Random-access iterator to the first output element. May be equal to @p first.
+ * @param init First output value.
+ * @param op Associative operator.
+ * @return Iterator following the last output element.
+ */
+template<class InIt, class OutIt, class T, class Op> OutIt parallel_exclusive_scan(InIt first, InIt last, OutIt out, T init, Op op)
+{
+    return parallel_scan(first, last, out, init, op, false);
+};
+/**
+ * @brief Parallel exclusive prefix sum starting at @p init.
+ * @param first Random-access iterator to the first input element.
+ * @param last Iterator following the last input element.
+ * @param out Random-access iterator to the first output element. May be equal to @p first.
+ * @param init First output value (usually 0).
+ * @return Iterator following the last output element.
+ */
+template<class InIt, class OutIt, class T> OutIt parallel_exclusive_scan(InIt first, InIt last, OutIt out, T init)
+{
+    return parallel_scan(first, last, out, init, std::plus<T>(), false);
+};
+/**
+ * @brief Parallel std::copy_if: copies the elements of [@p first, @p last) for which @p pred is true to @p out, in their order.
+ * Pass 1 evaluates @p pred once per element and counts the selected elements of each part; an exclusive scan of the counts gives
+ * the output position of every part; pass 2 copies each part from its position.
+ * @param first Random-access iterator to the first input element.
+ * @param last Iterator following the last input element.
+ * @param out Random-access iterator to the output. Must not overlap the input.
+ * @param pred Predicate taking an element.
+ * @param grain Minimal number of elements per task.
+ * @return Iterator following the last copied element.
+ */
+template<class InIt, class OutIt, class P> OutIt parallel_copy_if(InIt first, InIt last, OutIt out, P pred, size_t grain = CSALGORITHM_GRAIN)
+{
+    size_t n = last - first;
+    size_t nParts = getAlgorithmTaskNumber(n, grain);
+    if (nParts == 1)
+        return std::copy_if(first, last, out, pred);
+
+    std::vector<unsigned char> keep(n);
+    std::vector<CSALGORITHM_PARTIAL<size_t>> counts(nParts);
+    parallel_for(0, nParts, [&](size_t p)
+    {
+        size_t c = 0;
+        for(size_t i=p*n/nParts; i<(p+1)*n/nParts; i++)
+        {
+            keep[i] = pred(first[i]) ? 1 : 0;
+            c += keep[i];
+        }
+        counts[p].value = c;
+    }, 1);
+
+    size_t total = 0;
+    for(size_t p=0; p<nParts; p++)
+    {
+        size_t c = counts[p].value;
+        counts[p].value = total;
+        total += c;
+    }
+
+    parallel_for(0, nParts, [&](size_t p)
+    {
+        size_t o = counts[p].value;
+        for(size_t i=p*n/nParts; i<(p+1)*n/nParts; i++)
+        {
+            if (keep[i])
+                out[o++] = first[i];
+        }
+    }, 1);
+    return out + total;
+};
+/**
+ * @brief Parallel stable partition: moves the elements of [@p first, @p last) for which @p pred is true before the others,
+ * keeping the relative order inside both groups (like std::stable_partition). The output positions of both groups are computed
+ * from the per-part counts as in parallel_copy_if(); the elements go through a temporary buffer of the size of the range.
+ * @param first Random-access iterator to the first element.
+ * @param last Iterator following the last element.
+ * @param pred Predicate taking an element.
+ * @param grain Minimal number of elements per task.
+ * @return Iterator to the first element of the second group.
+ */
+template<class It, class P> It parallel_partition(It first, It last, P pred, size_t grain = CSALGORITHM_GRAIN)
+{
+    typedef typename std::iterator_traits<It>::value_type T;
+    size_t n = last - first;
+    size_t nParts = getAlgorithmTaskNumber(n, grain);
+    if (nParts == 1)
+        return std::stable_partition(first, last, pred);
+
+    std::vector<unsigned char> keep(n);
+    std::vector<CSALGORITHM_PARTIAL<size_t>> counts(nParts);
+    parallel_for(0, nParts, [&](size_t p)
+    {
+        size_t c = 0;
+        for(size_t i=p*n/nParts; i<(p+1)*n/nParts; i++)
+        {
+            keep[i] = pred(first[i]) ? 1 : 0;
+            c += keep[i];
+        }
+        counts[p].value = c;
+    }, 1);
+
+    // Les elements retenus d'une part commencent apres ceux des parts precedentes ; les autres, apres tous les retenus
+    size_t nTrue = 0;
+    for(size_t p=0; p<nParts; p++)
+    {
+        size_t c = counts[p].value;
+        counts[p].value = nTrue;
+        nTrue += c;
+    }
+
+    std::vector<T> buffer(n);
+    parallel_for(0, nParts, [&](size_t p)
+    {
+        size_t a = p*n/nParts, b = (p+1)*n/nParts;
+        size_t t = counts[p].value;
+        size_t f = nTrue + (a - t);
+        for(size_t i=a; i<b; i++)
+        {
+            if (keep[i])
+                buffer[t++] = std::move(first[i]);
+            else
+                buffer[f++] = std::move(first[i]);
+        }
+    }, 1);
+
+    parallel_for(0, n, [&](size_t i)
+    {
+        first[i] = std::move(buffer[i]);
+    });
+    return first + nTrue;
+};
+
+}
+
+#endif // CSALGORITHM_H_INCLUDED
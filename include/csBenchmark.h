@@ -0,0 +1,165 @@
+#pragma once
+
+#if defined _WIN32 || defined __CYGWIN__
+  #ifdef BUILDING_CSPARALLEL_DLL
+    #define CS_PARALLEL_TASK_API __declspec(dllexport)
+  #else
+    #define CS_PARALLEL_TASK_API __declspec(dllimport)
+  #endif
+#else
+  #ifdef BUILDING_CSPARALLEL_DLL
+    #define CS_PARALLEL_TASK_API __attribute__ ((visibility ("default")))
+  #else
+    #define CS_PARALLEL_TASK_API
+  #endif
+#endif
+
+#ifndef CSBENCHMARK_H_INCLUDED
+#define CSBENCHMARK_H_INCLUDED
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+#include "csPerfChecker.h"
+
+// Valeurs par defaut : executions d'echauffement ignorees et executions mesurees
+#define CSBENCH_WARMUP              2
+#define CSBENCH_REPETITIONS         30
+
+// Duree minimale d'un echantillon : les executions plus courtes sont repetees en lot et le temps du lot est divise
+#define CSBENCH_MIN_SAMPLE_NS       10000.0
+
+// Filtre des valeurs aberrantes
+#define CSBENCH_OUTLIER_NONE        0
+#define CSBENCH_OUTLIER_MAD         1
+#define CSBENCH_OUTLIER_IQR         2
+
+// Seuils par defaut : ecarts a la mediane en MAD normalisee, ou multiples de l'ecart interquartile
+#define CSBENCH_MAD_THRESHOLD       3.5
+#define CSBENCH_IQR_THRESHOLD       1.5
+
+// Statistiques d'un benchmark, toutes les durees en nanosecondes par execution
+typedef struct
+{
+  std::string name;
+  size_t warmup;
+  size_t repetitions;
+  size_t batch;
+  size_t kept;
+  size_t outliers;
+  double min;
+  double max;
+  double median;
+  double mean;
+  double p95;
+  double p99;
+  double stddev;
+  std::vector<double> samples;
+  bool hasCounters;
+  CSPERF_COUNTERS counters;
+}CSBENCH_RESULT;
+
+class CS_PARALLEL_TASK_API CSBENCHMARK
+{
+  private:
+  size_t warmup;
+  size_t repetitions;
+  int outlierFilter = CSBENCH_OUTLIER_MAD;
+  double outlierThreshold = CSBENCH_MAD_THRESHOLD;
+  double minSampleTime = CSBENCH_MIN_SAMPLE_NS;
+  int unit = CSTIME_UNIT_MICROSECOND;
+  int counterMode = CSPERF_COUNTERS_OFF;
+  std::vector<CSBENCH_RESULT> results;
+
+  public:
+/**
+ * @brief Constructs a benchmark harness.
+ * @param repetitions Number of timed samples per benchmark.
+ * @param warmup Number of untimed runs before the samples.
+ */
+  CSBENCHMARK(size_t repetitions = CSBENCH_REPETITIONS, size_t warmup = CSBENCH_WARMUP);
+/**
+ * @brief Sets the number of timed samples per benchmark.
+ * @param repetitions Number of samples (at least 1).
+ */
+  void setRepetitions(size_t repetitions);
+/**
+ * @brief Sets the number of untimed runs done before the samples (caches, page faults, pool wake-up, frequency).
+ * @param warmup Number of warm-up runs.
+ */
+  void setWarmup(size_t warmup);
+/**
+ * @brief Selects the filter applied to the samples before the statistics; the filtered samples stay in CSBENCH_RESULT::samples.
+ * CSBENCH_OUTLIER_MAD drops the samples further than @p threshold normalized median absolute deviations from the median,
+ * CSBENCH_OUTLIER_IQR those outside [Q1 - threshold x IQR, Q3 + threshold x IQR].
+ * @param filter One of the CSBENCH_OUTLIER_* constants.
+ * @param threshold Filter threshold; 0 selects CSBENCH_MAD_THRESHOLD or CSBENCH_IQR_THRESHOLD.
+ */
+  void setOutlierFilter(int filter, double threshold = 0.0);
+/**
+ * @brief Sets the minimum duration of a sample. A run shorter than that (measured during the warm-up) is repeated in batches
+ * and each sample is the batch time divided by the batch size, so sub-microsecond runs are not lost in the clock resolution.
+ * @param ns Minimum sample duration in nanoseconds; 0 times every run on its own.
+ */
+  void setMinSampleTime(double ns);
+/**
+ * @brief Sets the time unit used by printReport(). Results are always stored in nanoseconds.
+ * @param unit Time unit (see CSTIME_UNIT_* constants).
+ */
+  void setTimeUnit(int unit);
+/**
+ * @brief Reads hardware counters during the samples (see CSPERF_CHECKER::setCounterMode()); the result holds their mean per run.
+ * @param mode CSPERF_COUNTERS_OFF, CSPERF_COUNTERS_THREAD or CSPERF_COUNTERS_WORKERS.
+ */
+  void setCounterMode(int mode);
+/**
+ * @brief Benchmarks @p func: warm-up runs, then the timed samples, then the statistics. The result is also kept for the reports.
+ * @param name Name of the benchmark.
+ * @param func Code to measure.
+ * @return Statistics of the run.
+ */
+  CSBENCH_RESULT run(const char* name, const std::function<void()>& func);
+/**
+ * @brief Benchmarks csParallelTask::execute(@p idf).
+ * @param name Name of the benchmark.
+ * @param idf Index of a registered function.
+ * @return Statistics of the run.
+ */
+  CSBENCH_RESULT runFunction(const char* name, size_t idf);
+/**
+ * @brief Computes the statistics of a set of samples with the current outlier filter.
+ * @param name Name of the benchmark.
+ * @param samples Durations in nanoseconds.
+ * @return Statistics; warmup and batch are left to 0 and 1.
+ */
+  CSBENCH_RESULT computeStatistics(const char* name, const std::vector<double>& samples);
+/**
+ * @brief Returns the results of the benchmarks run so far.
+ * @return Results in run order.
+ */
+  const std::vector<CSBENCH_RESULT>& getResults();
+/**
+ * @brief Drops the stored results.
+ */
+  void clear();
+/**
+ * @brief Prints one line per benchmark: min, median, mean, p95, p99 and standard deviation in the chosen unit,
+ * the number of outliers, and the speedup of the median against the first benchmark.
+ */
+  void printReport();
+/**
+ * @brief Writes the results as JSON: settings and statistics in nanoseconds, the raw samples and the counters.
+ * @param path Output file.
+ * @return false if the file cannot be written.
+ */
+  bool writeJson(const char* path);
+/**
+ * @brief Writes the statistics as CSV, one row per benchmark, durations in nanoseconds.
+ * @param path Output file.
+ * @return false if the file cannot be written.
+ */
+  bool writeCsv(const char* path);
+};
+
+#endif // CSBENCHMARK_H_INCLUDED
@@ -0,0 +1,79 @@
+#pragma once
+
+#if defined _WIN32 || defined __CYGWIN__
+  #ifdef BUILDING_CSPARALLEL_DLL
+    #define CS_PARALLEL_TASK_API __declspec(dllexport)
+  #else
+    #define CS_PARALLEL_TASK_API __declspec(dllimport)
+  #endif
+#else
+  #ifdef BUILDING_CSPARALLEL_DLL
+    #define CS_PARALLEL_TASK_API __attribute__ ((visibility ("default")))
+  #else
+    #define CS_PARALLEL_TASK_API
+  #endif
+#endif
+
+#ifndef CSGEMM_H_INCLUDED
+#define CSGEMM_H_INCLUDED
+
+#include <cstddef>
+
+#define CSGEMM_KERNEL_AUTO    0
+#define CSGEMM_KERNEL_SCALAR  1
+#define CSGEMM_KERNEL_AVX2    2
+
+// Taille du micro-noyau : bloc de C garde dans les registres (6x8 doubles = 12 registres AVX2)
+#define CSGEMM_MR   6
+#define CSGEMM_NR   8
+// Blocage des caches : un panneau KC x NR de B tient en L1, un bloc MC x KC de A en L2, un bloc KC x NC de B en L3
+#define CSGEMM_KC   256
+#define CSGEMM_MC   96
+#define CSGEMM_NC   2048
+
+namespace csParallelTask
+{
+
+/**
+ * @brief Computes C = alpha*A*B + beta*C on the shared worker pool. The matrices are stored row by row (row-major).
+ * C is cut into tiles of CSGEMM_MC rows, run in Morton order as parallel tasks. Each task packs the blocks of A (MC x KC)
+ * and B (KC x NC) it needs in contiguous, cache-sized buffers, then updates its tile CSGEMM_MR x CSGEMM_NR at a time with
+ * the micro-kernel selected by setGemmKernel() (AVX2/FMA when the CPU supports it, scalar otherwise).
+ * @param M Number of rows of A and C.
+ * @param N Number of columns of B and C.
+ * @param K Number of columns of A and rows of B.
+ * @param alpha Factor of the product.
+ * @param A Matrix M x K.
+ * @param lda Distance between two rows of A (at least K).
+ * @param B Matrix K x N.
+ * @param ldb Distance between two rows of B (at least N).
+ * @param beta Factor of C. With beta = 0, C is not read (it may hold NaN).
+ * @param C Matrix M x N.
+ * @param ldc Distance between two rows of C (at least N).
+ */
+void gemm(size_t M, size_t N, size_t K, double alpha, const double* A, size_t lda, const double* B, size_t ldb, double beta, double* C, size_t ldc);
+/**
+ * @brief Computes C = A*B for dense row-major matrices (see gemm()).
+ * @param M Number of rows of A and C.
+ * @param N Number of columns of B and C.
+ * @param K Number of columns of A and rows of B.
+ * @param A Matrix M x K.
+ * @param B Matrix K x N.
+ * @param C Matrix M x N.
+ */
+void matrixMultiply(size_t M, size_t N, size_t K, const double* A, const double* B, double* C);
+/**
+ * @brief Selects the micro-kernel of gemm().
+ * @param kernel CSGEMM_KERNEL_AUTO (default: AVX2/FMA if the CPU supports it), CSGEMM_KERNEL_SCALAR or CSGEMM_KERNEL_AVX2.
+ * @return false if the kernel is not supported by the CPU (the selection is then unchanged).
+ */
+bool setGemmKernel(int kernel);
+/**
+ * @brief Returns the micro-kernel gemm() uses.
+ * @return CSGEMM_KERNEL_SCALAR or CSGEMM_KERNEL_AVX2.
+ */
+int getGemmKernel();
+
+}
+
+#endif // CSGEMM_H_INCLUDED
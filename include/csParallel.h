@@ -23,13 +23,87 @@
 #include <vector>
 #include <string>
 #include <string.h>
+#include <tuple>
+#ifdef _WIN32
 #include <memoryapi.h>
-#include "CSPARGS.h"
+#endif
+#include "csPargs.h"
 #include "csPerfChecker.h"
+#include "csThreadPool.h"
+#include "csAffinity.h"
+
+#define CSSCHEDULE_STATIC           0
+#define CSSCHEDULE_WORK_STEALING    1
+#define CSSCHEDULE_DYNAMIC          2
+#define CSSCHEDULE_GUIDED           3
+
+// Desequilibre (temps du bloc le plus lent / temps moyen) au-dela duquel une forme adaptative est recalculee
+#define CSADAPTIVE_TOLERANCE        1.1
+
+// Identifiant retourne quand aucune fonction ne correspond
+#define CSTASK_INVALID_ID           ((size_t)-1)
 
 using namespace std;
 
 typedef CSPARGS::BOUNDS* BUFFER_SHAPE;
+typedef CSPARGS::TILE* TILE_SHAPE;
+
+// Mesure d'un bloc lors de la derniere execution ; les instants sont relatifs au lancement, en nanosecondes
+typedef struct
+{
+  size_t block;
+  size_t worker;
+  double start;
+  double end;
+  double wallTime;
+  double cpuTime;
+  size_t chunks;
+}CSBLOCK_TIMING;
+
+// Mesures de la derniere execution d'une fonction et indicateurs de desequilibre
+typedef struct
+{
+  vector<CSBLOCK_TIMING> blocks;
+  size_t nThreads;
+  double span;
+  double meanTime;
+  double maxTime;
+  double imbalance;
+  double idleTime;
+  double dispatchLatency;
+  double maxDispatchLatency;
+}CSEXECUTION_TIMING;
+
+// Fonction typee enregistree : invoke est le trampoline genere pour le type de l'appelable
+typedef struct
+{
+  void (*invoke)(void* callable, CSPARGS& args);
+  void (*destroy)(void* callable);
+  void* callable;
+}CSCALLABLE;
+
+template<class F, class... _Types> class CSCALLABLE_BINDING
+{
+public:
+  CSCALLABLE_BINDING(F _func, _Types... _args) : func(_func), args(_args...)
+  {
+  };
+
+  static void invoke(void* callable, CSPARGS& blockArgs)
+  {
+    CSCALLABLE_BINDING* binding = (CSCALLABLE_BINDING*)callable;
+    std::apply([binding, &blockArgs](_Types&... a){ binding->func(blockArgs, a...); }, binding->args);
+  };
+
+  static void destroy(void* callable)
+  {
+    delete (CSCALLABLE_BINDING*)callable;
+  };
+
+private:
+  F func;
+  std::tuple<_Types...> args;
+};
 
 namespace csParallelTask
 {
@@ -47,6 +121,18 @@ template<typename... _Args> void registerArgs(void**&Args, size_t& nbArgs, void*
   registerArgs(Args, nbArgs, args...);
 };
 
+/**
+ * @brief Returns min(nThread, getAvailableConcurrency()), where getAvailableConcurrency() gives the number of threads the process can run at the same time
+ * (affinity mask, cgroup CPU quota or CSPARALLEL_NUM_THREADS).
+ * @param nThread Requested number of threads.
+ * @return min(nThread, getAvailableConcurrency()).
+ */
+size_t getSafeThreadNumber(size_t nThread);
+/**
+ * @brief Returns the number of hardware threads (CPU cores/threads) of the machine, ignoring the affinity mask and the container limits (see getAvailableConcurrency()).
+ * @return Number of hardware threads.
+ */
+size_t getHardwareConcurrency();
 /**
  * @brief Configures the arguments for each buffer block of the function identified by @p idf.
  * @param idf Index of the registered function.
@@ -73,6 +159,12 @@ void setBufferShape(size_t idf, BUFFER_SHAPE shape);
  * @param workSize New total buffer size.
  */
 void setBufferShapeRegular(size_t idf, size_t workSize);
+/**
+ * @brief Assigns new tile extents to the blocks of the function @p idf (one tile per block, same number of tiles).
+ * @param idf Index of the function.
+ * @param shape Array containing the extents of each block.
+ */
+void setTileShape(size_t idf, TILE_SHAPE shape);
 /**
  * @brief Sets a time delay (in nanoseconds) inside loops to improve safe execution.
  * @param idf Index of the function.
@@ -87,6 +179,7 @@ void setDelay(size_t idf, size_t delay);
 void setDelay(size_t idf, vector<size_t> delayList);
 /**
  * @brief Defines whether the function will be executed normally or in background.
+ * In background mode, execute() returns without waiting; the blocks can be awaited through getBackgroundExecution().
  * @param idf Index of the function.
  * @param execMode Execution mode. Can be CSTHREAD_NORMAL_EXECUTION or CSTHREAD_BACKGROUND_EXECUTION.
  */
@@ -97,13 +190,154 @@ void setExecutionMode(size_t idf, bool execMode);
  * @param execMode List of execution modes for each thread. Each one can be CSTHREAD_NORMAL_EXECUTION or CSTHREAD_BACKGROUND_EXECUTION.
  */
 void setExecutionMode(size_t idf, vector<bool> execMode);
+/**
+ * @brief Selects how the buffer blocks of the function @p idf are scheduled on the worker threads.
+ * @param idf Index of the function.
+ * @param schedule CSSCHEDULE_STATIC: each thread processes its whole block in one call (default).
+ * CSSCHEDULE_WORK_STEALING: each block is split into chunks of @p chunkSize elements; a thread that runs out of chunks steals half of the remaining work of a busy thread.
+ * CSSCHEDULE_DYNAMIC: threads claim chunks of @p chunkSize elements of [0, workSize) in order, whatever the buffer shape.
+ * CSSCHEDULE_GUIDED: like CSSCHEDULE_DYNAMIC with chunks proportional to the remaining work divided by the block number, never smaller than @p chunkSize.
+ * Except in static mode, the function is called once per chunk unless it iterates itself with CSPARGS::nextChunk().
+ * @param chunkSize Number of elements per chunk (grain size). 0 selects workSize/(16*nBlocks).
+ */
+void setSchedulingMode(size_t idf, int schedule, size_t chunkSize = 0);
+/**
+ * @brief Returns the scheduling mode of the function @p idf.
+ * @param idf Index of the function.
+ * @return One of the CSSCHEDULE_* constants.
+ */
+int getSchedulingMode(size_t idf);
+/**
+ * @brief Enables the adaptive shape of the function @p idf. Each synchronous execute() then measures the wall time of every block;
+ * when the slowest block takes more than @p tolerance times the mean, the blocks are reshaped for the next call so that they get equal
+ * measured costs (the cost per element is taken as uniform inside each block). Suited to repeated steps with a stable imbalance.
+ * Requires static scheduling and contiguous blocks covering one interval (regular, cost or custom 1D shapes); tiled functions are not reshaped.
+ * @param idf Index of the function.
+ * @param adaptive true to enable, false to keep the current shape.
+ * @param tolerance Imbalance ratio (max/mean block time) below which the shape is kept.
+ */
+void setAdaptiveShape(size_t idf, bool adaptive, double tolerance = CSADAPTIVE_TOLERANCE);
+/**
+ * @brief Returns whether the adaptive shape of the function @p idf is enabled.
+ * @param idf Index of the function.
+ * @return true if enabled.
+ */
+bool getAdaptiveShape(size_t idf);
+/**
+ * @brief Returns the wall time of each block measured during the last execution of the function @p idf.
+ * @param idf Index of the function.
+ * @return Time of each block in nanoseconds (empty if neither the adaptive shape nor the block timing is enabled).
+ */
+vector<double> getBlockTimes(size_t idf);
+/**
+ * @brief Enables the per-block timing of the function @p idf. Each execution (execute(), executeAsync(), task graphs) then records,
+ * for every block, its start and end relative to the launch, its wall time, the CPU time of its thread and the worker that ran it.
+ * Measuring costs two clock reads and two thread CPU time reads per block.
+ * @param idf Index of the function.
+ * @param enable true to enable, false to disable.
+ */
+void setBlockTiming(size_t idf, bool enable);
+/**
+ * @brief Returns whether the per-block timing of the function @p idf is enabled.
+ * @param idf Index of the function.
+ * @return true if enabled.
+ */
+bool getBlockTiming(size_t idf);
+/**
+ * @brief Returns the block records of the last execution of the function @p idf with the derived metrics:
+ * span (launch to end of the last block), mean and max block wall time, imbalance (max/mean), idle time
+ * (nThreads*span minus the summed wall times, where nThreads is the number of distinct threads that ran blocks),
+ * and dispatch latency (mean and max delay between the launch and the start of a block).
+ * Call it once the execution is complete (after execute() returns, or after waiting for the future of an asynchronous execution).
+ * @param idf Index of the function.
+ * @return Measures of the last execution; blocks is empty if the timing is disabled.
+ */
+CSEXECUTION_TIMING getExecutionTiming(size_t idf);
 /**
  * @brief Creates @p nBlocks buffer blocks of equal size; each block is processed by one thread.
+ * When @p workSize is not a multiple of @p nBlocks, the remainder is spread over the blocks (their sizes differ by at most one).
  * @param workSize Total buffer size.
  * @param nBlocks Number of buffer blocks. Each block is managed by one thread. @p nBlocks is reduced to the number of hardware threads if its value is greater.
  * @return BUFFER_SHAPE Array containing all the created buffer blocks.
  */
 BUFFER_SHAPE  makeRegularBufferShape(size_t workSize, size_t nBlocks);
+/**
+ * @brief Creates @p nBlocks contiguous blocks of equal cost rather than equal size.
+ * Each boundary is placed where the prefix sum of the costs is closest to k*total/nBlocks (binary search).
+ * @param workSize Total buffer size.
+ * @param nBlocks Number of buffer blocks.
+ * @param prefixCost Inclusive prefix sum of the element costs: prefixCost[i] is the cost of the elements [0, i]. Must be non-decreasing, @p workSize values.
+ * @return BUFFER_SHAPE Array containing the blocks, to be released with free(). Blocks may be empty when single elements are very expensive.
+ */
+BUFFER_SHAPE makePrefixCostBufferShape(size_t workSize, size_t nBlocks, const double* prefixCost);
+/**
+ * @brief Creates @p nBlocks contiguous blocks of equal cost, the cost of element i being @p cost(i) (see makePrefixCostBufferShape()).
+ * @param workSize Total buffer size.
+ * @param nBlocks Number of buffer blocks.
+ * @param cost Callable taking a size_t index and returning the non-negative cost of the element, as a double.
+ * @return BUFFER_SHAPE Array containing the blocks, to be released with free().
+ */
+template<class F> BUFFER_SHAPE makeCostBufferShape(size_t workSize, size_t nBlocks, F cost)
+{
+  vector<double> prefix(workSize);
+  double sum = 0.0;
+  for(size_t i=0; i<workSize; i++)
+  {
+    sum += cost(i);
+    prefix[i] = sum;
+  }
+  return makePrefixCostBufferShape(workSize, nBlocks, prefix.data());
+};
+/**
+ * @brief Cuts a @p rows x @p cols domain into @p nBands bands of full rows.
+ * @param rows Number of rows.
+ * @param cols Number of columns.
+ * @param nBands Number of bands.
+ * @return TILE_SHAPE Array of @p nBands tiles, to be released with free().
+ */
+TILE_SHAPE makeRowBandShape(size_t rows, size_t cols, size_t nBands);
+/**
+ * @brief Cuts a @p rows x @p cols domain into @p nBands bands of full columns.
+ * @param rows Number of rows.
+ * @param cols Number of columns.
+ * @param nBands Number of bands.
+ * @return TILE_SHAPE Array of @p nBands tiles, to be released with free().
+ */
+TILE_SHAPE makeColumnBandShape(size_t rows, size_t cols, size_t nBands);
+/**
+ * @brief Cuts a @p rows x @p cols domain into tiles of @p tileRows x @p tileCols (smaller on the last row and column), in row-major order.
+ * @param rows Number of rows.
+ * @param cols Number of columns.
+ * @param tileRows Number of rows per tile.
+ * @param tileCols Number of columns per tile.
+ * @param nTiles Output number of tiles.
+ * @return TILE_SHAPE Array of tiles, to be released with free().
+ */
+TILE_SHAPE makeTileShape(size_t rows, size_t cols, size_t tileRows, size_t tileCols, size_t* nTiles);
+/**
+ * @brief Same as makeTileShape() with the tiles ordered along the Morton (Z-order) curve: consecutive tiles are close in both directions,
+ * so the tiles processed at the same time by the workers share more rows and columns of the inputs in the caches.
+ * @param rows Number of rows.
+ * @param cols Number of columns.
+ * @param tileRows Number of rows per tile.
+ * @param tileCols Number of columns per tile.
+ * @param nTiles Output number of tiles.
+ * @return TILE_SHAPE Array of tiles, to be released with free().
+ */
+TILE_SHAPE makeMortonTileShape(size_t rows, size_t cols, size_t tileRows, size_t tileCols, size_t* nTiles);
+/**
+ * @brief Cuts a @p slices x @p rows x @p cols volume into 3D tiles, in row-major order (x fastest) or along the 3D Morton curve.
+ * @param slices Number of slices (z).
+ * @param rows Number of rows (y).
+ * @param cols Number of columns (x).
+ * @param tileSlices Number of slices per tile.
+ * @param tileRows Number of rows per tile.
+ * @param tileCols Number of columns per tile.
+ * @param nTiles Output number of tiles.
+ * @param morton true to order the tiles along the Morton curve.
+ * @return TILE_SHAPE Array of tiles, to be released with free().
+ */
+TILE_SHAPE makeTileShape3D(size_t slices, size_t rows, size_t cols, size_t tileSlices, size_t tileRows, size_t tileCols, size_t* nTiles, bool morton = false);
 /**
  * @brief Registers a new function to be executed in parallel.
  * @param nBlocks Number of buffer blocks, each corresponding to one thread.
@@ -112,7 +346,7 @@ BUFFER_SHAPE  makeRegularBufferShape(size_t workSize, size_t nBlocks);
  * @param charfName Name of the function to register.
  * @param blockFunc Pointer to the function to register.
  * @param funcArgs CSPARGS object containing the arguments of the function.
- * @return Index of the registered function.
+ * @return Index of the registered function, valid until it is unregistered, or CSTASK_INVALID_ID if the registration failed.
  */
 size_t registerFunction(size_t nBlocks, size_t workSize, BUFFER_SHAPE shape, const char* fName, void(*blockFunc)(CSPARGS), CSPARGS funcArgs);
 /**
@@ -152,7 +386,7 @@ template<typename... _Args> size_t registerFunctionRegularEx(size_t nBlocks, siz
 
   registerArgs(Args, nbArgs, arg, args...);
 
-  BUFFER_SHAPE shape = makeRegularBufferShape(workSize, nBlocks);
+  BUFFER_SHAPE shape = makeRegularBufferShape(workSize, getSafeThreadNumber(nBlocks));
   CSPARGS funcArgs(nbArgs);
   funcArgs.regArgs2(Args,nbArgs);
 
@@ -161,25 +395,186 @@ template<typename... _Args> size_t registerFunctionRegularEx(size_t nBlocks, siz
   return idf;
 };
 /**
- * @brief Unregisters the function indexed by @p idf and removes its arguments.
+ * @brief Registers a function executed once per tile of @p shape. Each tile is one block, and the number of blocks is not reduced to the
+ * number of threads: the worker pool distributes the tiles, in the order of @p shape. The kernel reads its extents with CSPARGS::getTile();
+ * CSPARGS::getBounds() returns the rows of the tile.
+ * @param shape Array of tiles (makeRowBandShape, makeColumnBandShape, makeTileShape, makeMortonTileShape, makeTileShape3D). It is copied.
+ * @param nTiles Number of tiles.
+ * @param fName Name of the function to register.
+ * @param blockFunc Pointer to the function to register.
+ * @param funcArgs CSPARGS object containing the arguments of the function.
+ * @return Index of the registered function, or CSTASK_INVALID_ID if the registration failed.
+ */
+size_t registerFunctionTiled(TILE_SHAPE shape, size_t nTiles, const char* fName, void(*blockFunc)(CSPARGS), CSPARGS funcArgs);
+/**
+ * @brief Convenience template for registerFunctionTiled(). Builds the argument array from variadic pointers.
+ * @param shape Array of tiles.
+ * @param nTiles Number of tiles.
+ * @param fName Name of the function to register.
+ * @param Function Pointer to the function to register.
+ * @param arg Void pointer to the first argument.
+ * @param args Other argument pointers (variadic).
+ * @return Index of the registered function.
+ */
+template<typename... _Args> size_t registerFunctionTiledEx(TILE_SHAPE shape, size_t nTiles, const char* fName, void(*Function)(CSPARGS), void*arg, _Args... args)
+{
+  void **Args = 0;
+  size_t nbArgs = 0;
+
+  registerArgs(Args, nbArgs, arg, args...);
+
+  CSPARGS funcArgs(nbArgs);
+  funcArgs.regArgs2(Args,nbArgs);
+  return registerFunctionTiled(shape, nTiles, fName, Function, funcArgs);
+};
+/**
+ * @brief Registers a type-erased callable executed once per tile. Used by registerTaskTiled().
+ * @param shape Array of tiles.
+ * @param nTiles Number of tiles.
+ * @param fName Name of the function to register.
+ * @param callable Callable object with its trampoline.
+ * @return Index of the registered function.
+ */
+size_t registerCallableTiled(TILE_SHAPE shape, size_t nTiles, const char* fName, CSCALLABLE callable);
+/**
+ * @brief Registers a type-erased callable. Used by registerTask(); @p callable is destroyed when the function is unregistered.
+ * @param nBlocks Number of buffer blocks, each corresponding to one thread.
+ * @param workSize Total buffer size.
+ * @param shape Array containing the bounds of each block to be created.
+ * @param fName Name of the function to register.
+ * @param callable Callable object with its trampoline.
+ * @return Index of the registered function.
+ */
+size_t registerCallable(size_t nBlocks, size_t workSize, BUFFER_SHAPE shape, const char* fName, CSCALLABLE callable);
+/**
+ * @brief Registers any callable (function, functor, capturing lambda) with typed arguments. The arguments are copied into a tuple
+ * shared by all the blocks, and each block calls func(CSPARGS& blockArgs, args&...) through a trampoline generated for the type of @p func,
+ * so the kernel body can be inlined. Output buffers are passed as pointers.
+ * The function is executed with execute(), executeAsync() or a CSTASK_GRAPH like any other registered function.
+ * @param nBlocks Number of buffer blocks, each corresponding to one thread.
+ * @param workSize Total buffer size.
+ * @param shape Array containing the bounds of each block to be created.
+ * @param fName Name of the function to register.
+ * @param func Callable taking a CSPARGS& followed by references to the argument types.
+ * @param args Typed arguments.
+ * @return Index of the registered function.
+ */
+template<class F, class... _Types> size_t registerTask(size_t nBlocks, size_t workSize, BUFFER_SHAPE shape, const char* fName, F func, _Types... args)
+{
+  CSCALLABLE callable;
+  callable.invoke = CSCALLABLE_BINDING<F, _Types...>::invoke;
+  callable.destroy = CSCALLABLE_BINDING<F, _Types...>::destroy;
+  callable.callable = new CSCALLABLE_BINDING<F, _Types...>(func, args...);
+  return registerCallable(nBlocks, workSize, shape, fName, callable);
+};
+/**
+ * @brief Same as registerTask() with regular (same size) buffer blocks.
+ * @param nBlocks Number of buffer blocks, each corresponding to one thread.
+ * @param workSize Total buffer size used to build regular blocks.
+ * @param fName Name of the function to register.
+ * @param func Callable taking a CSPARGS& followed by references to the argument types.
+ * @param args Typed arguments.
+ * @return Index of the registered function.
+ */
+template<class F, class... _Types> size_t registerTaskRegular(size_t nBlocks, size_t workSize, const char* fName, F func, _Types... args)
+{
+  BUFFER_SHAPE shape = makeRegularBufferShape(workSize, getSafeThreadNumber(nBlocks));
+  size_t idf = registerTask(nBlocks, workSize, shape, fName, func, args...);
+  free(shape);
+  return idf;
+};
+/**
+ * @brief Same as registerTask() with one block per tile of @p shape (see registerFunctionTiled()).
+ * @param shape Array of tiles.
+ * @param nTiles Number of tiles.
+ * @param fName Name of the function to register.
+ * @param func Callable taking a CSPARGS& followed by references to the argument types.
+ * @param args Typed arguments.
+ * @return Index of the registered function.
+ */
+template<class F, class... _Types> size_t registerTaskTiled(TILE_SHAPE shape, size_t nTiles, const char* fName, F func, _Types... args)
+{
+  CSCALLABLE callable;
+  callable.invoke = CSCALLABLE_BINDING<F, _Types...>::invoke;
+  callable.destroy = CSCALLABLE_BINDING<F, _Types...>::destroy;
+  callable.callable = new CSCALLABLE_BINDING<F, _Types...>(func, args...);
+  return registerCallableTiled(shape, nTiles, fName, callable);
+};
+/**
+ * @brief Unregisters the function indexed by @p idf and removes its arguments, in constant time. The indexes of the other functions are unchanged.
  * @param idf Index of the function to unregister.
  */
 void unregisterFunction(size_t idf);
 /**
- * @brief Unregisters all registered functions and clears their arguments.
+ * @brief Unregisters all registered functions and clears their arguments. The ids returned afterwards reuse the same slots
+ * but differ from the previous ones, which stay invalid: use the ids returned by the registration functions.
  */
 void unregisterAll();
 /**
- * @brief Returns min(nThread, getHardwareConcurrency()), where getHardwareConcurrency() gives the number of hardware threads of the CPU.
- * @param nThread Requested number of threads.
- * @return min(nThread, getHardwareConcurrency()).
+ * @brief Returns the worker pool shared by every registered function. The pool is created on first use with getAvailableConcurrency() workers.
+ * @return Pointer to the shared worker pool.
  */
-size_t getSafeThreadNumber(size_t nThread);
+CSTHREAD_POOL* getThreadPool();
 /**
- * @brief Returns the number of hardware threads (CPU cores/threads) available on the machine.
- * @return Number of hardware threads.
+ * @brief Restarts the shared worker pool with @p nWorkers threads.
+ * @param nWorkers Number of worker threads.
  */
-size_t getHardwareConcurrency();
+void setThreadPoolSize(size_t nWorkers);
+/**
+ * @brief Binds the workers of the shared pool to CPUs. Worker w is bound to the CPU w (modulo the list) of the chosen order.
+ * @param policy CSAFFINITY_COMPACT (neighbour workers share caches), CSAFFINITY_SCATTER (neighbour workers on separate nodes and cores),
+ * CSAFFINITY_LIST (@p cpuList), CSAFFINITY_NUMA (same as compact) or CSAFFINITY_NONE (workers free to run on any available CPU).
+ * @param cpuList CPU numbers used with CSAFFINITY_LIST.
+ */
+void setThreadAffinity(int policy, vector<size_t> cpuList = vector<size_t>());
+/**
+ * @brief Sets where the blocks of the function @p idf are executed. With a policy other than CSAFFINITY_NONE, block i is always
+ * executed by the worker bound to the same CPU, so the data it first touched stays close to it; the pool is bound in compact order if it is not bound yet.
+ * CSAFFINITY_COMPACT / CSAFFINITY_SCATTER: block i on the CPU i of the order. CSAFFINITY_LIST: block i on @p cpuList[i % size].
+ * CSAFFINITY_NUMA: the blocks are cut into contiguous slices, one per NUMA node, and each slice runs on the CPUs of its node.
+ * @param idf Index of the function.
+ * @param policy Placement policy.
+ * @param cpuList CPU numbers used with CSAFFINITY_LIST.
+ */
+void setAffinityMode(size_t idf, int policy, vector<size_t> cpuList = vector<size_t>());
+/**
+ * @brief Returns the placement policy of the function @p idf.
+ * @param idf Index of the function.
+ * @return CSAFFINITY_NONE, CSAFFINITY_COMPACT, CSAFFINITY_SCATTER, CSAFFINITY_LIST or CSAFFINITY_NUMA.
+ */
+int getAffinityMode(size_t idf);
+/**
+ * @brief Runs @p func once per block of the function @p idf, with the bounds of the block and on the worker that executes the block.
+ * Used to initialise the buffers in parallel (first touch) so that their pages are allocated on the node of the block that uses them.
+ * @param idf Index of the function.
+ * @param func Function called with @p ctx and the arguments of each block.
+ * @param ctx User pointer passed to @p func.
+ */
+void executeOnBlocks(size_t idf, void (*func)(void* ctx, CSPARGS& args), void* ctx);
+/**
+ * @brief Fills @p data[first, last) with @p value from the block that owns each range of the function @p idf (parallel first touch).
+ * Call it once after setAffinityMode(), before the buffer is used, on memory that has not been written yet.
+ * @param idf Index of the function.
+ * @param data Buffer indexed like the blocks of @p idf.
+ * @param value Initial value.
+ */
+template<class T> void firstTouch(size_t idf, T* data, T value)
+{
+  struct FILL
+  {
+    T* data;
+    T value;
+    static void run(void* ctx, CSPARGS& args)
+    {
+      FILL* f = (FILL*)ctx;
+      CSPARGS::BOUNDS b = args.getBounds();
+      for(size_t i=b.first; i<b.last; i++)
+        f->data[i] = f->value;
+    }
+  };
+  FILL fill = {data, value};
+  executeOnBlocks(idf, FILL::run, &fill);
+};
 /**
  * @brief Returns the CSPARGS objects for all buffer blocks of the specified function.
  * @param idf Index of the function.
@@ -194,16 +589,52 @@ vector<CSPARGS> getArgs(size_t idf);
  */
 CSPARGS getArgs(size_t idf, size_t ida);
 /**
- * @brief Returns the index of the function identified by its name @p funcName.
- * @return Index of the specified function.
+ * @brief Returns the number of buffer blocks (threads) of the function @p idf, after the reduction to getAvailableConcurrency().
+ * @param idf Index of the function.
+ * @return Number of buffer blocks.
+ */
+size_t getBlockNumber(size_t idf);
+/**
+ * @brief Changes the number of buffer blocks of the function @p idf. The blocks are rebuilt as regular blocks over [0, workSize), with the
+ * arguments, delay and execution mode of the first block; the placement policy is applied again. Tiled functions keep their blocks.
+ * Waits for the blocks still running in background.
+ * @param idf Index of the function.
+ * @param nBlocks New number of blocks, reduced to getAvailableConcurrency() if greater.
+ */
+void setBlockNumber(size_t idf, size_t nBlocks);
+/**
+ * @brief Returns the chunk size set with setSchedulingMode() for the function @p idf.
+ * @param idf Index of the function.
+ * @return Number of elements per chunk, 0 for the default size.
+ */
+size_t getChunkSize(size_t idf);
+/**
+ * @brief Returns the name of the function @p idf given at registration (its index when no name was given).
+ * @param idf Index of the function.
+ * @return Name of the function, empty if @p idf is invalid.
+ */
+string getFunctionName(size_t idf);
+/**
+ * @brief Returns the index of the function identified by its name @p funcName (hashed lookup).
+ * If several functions share the name, the first registered one that is still registered is returned.
+ * @param funcName Name of the function.
+ * @return Index of the specified function, or CSTASK_INVALID_ID if no registered function has this name.
  */
 size_t getId(const char*funcName);
 /**
- * @brief Returns the index of the function identified by its function pointer @p f.
+ * @brief Returns the index of the function identified by its function pointer @p f (hashed lookup).
+ * If several functions share the pointer, the first registered one that is still registered is returned.
  * @param f Address of the function.
- * @return Index of the specified function.
+ * @return Index of the specified function, or CSTASK_INVALID_ID if @p f is not registered.
  */
 size_t getId(void(*f)(CSPARGS));
+/**
+ * @brief Tells whether @p idf designates a registered function. Indexes are stable: unregistering a function does not change the
+ * index of the others, and the index of an unregistered function is detected as invalid even after its slot is reused.
+ * @param idf Index of the function.
+ * @return true if the function is registered.
+ */
+bool isRegistered(size_t idf);
 /**
  * @brief Returns the global buffer size for the function indexed by @p idf.
  * @param idf Index of the function.
@@ -232,7 +663,8 @@ void updateArg(size_t idf, initializer_list<size_t> ida, initializer_list<void*>
  */
 template<size_t N> void updateArg(size_t idf, const size_t (&ida)[N], void* const (&arg)[N]);
 /**
- * @brief Runs all buffer blocks of the function @p id in parallel.
+ * @brief Runs all buffer blocks of the function @p id in parallel on the shared worker pool. The calling thread runs one of the blocks.
+ * Called from a worker (nested call), the blocks are queued to the same pool and the worker executes queued blocks until they are done.
  * @param id Index of the function to execute.
  */
 void execute(int id);
@@ -246,6 +678,33 @@ void execute(const char*funcName);
  * @param f Pointer to the function to execute.
  */
 void execute(void(*f)(CSPARGS));
+/**
+ * @brief Starts all buffer blocks of the function @p id on the worker pool and returns without waiting, whatever the execution mode.
+ * The arguments of the function must stay valid until the returned future is complete.
+ * @param id Index of the function to execute.
+ * @return Future used to wait for or poll the execution.
+ */
+CSTASK_FUTURE executeAsync(int id);
+/**
+ * @brief Starts all buffer blocks of the function identified by its name and returns without waiting.
+ * @param funcName Name of the function to execute.
+ * @return Future used to wait for or poll the execution.
+ */
+CSTASK_FUTURE executeAsync(const char*funcName);
+/**
+ * @brief Starts all buffer blocks of the function specified by pointer @p f and returns without waiting.
+ * @param f Pointer to the function to execute.
+ * @return Future used to wait for or poll the execution.
+ */
+CSTASK_FUTURE executeAsync(void(*f)(CSPARGS));
+/**
+ * @brief Returns the future of the last execution of the function @p idf that did not wait for its blocks:
+ * the last executeAsync() call, or the blocks launched in background (CSTHREAD_BACKGROUND_EXECUTION) by the last execute() call.
+ * unregisterFunction() and unregisterAll() wait for this execution before releasing the arguments.
+ * @param idf Index of the function.
+ * @return Future of the execution; an empty (completed) future if there is none.
+ */
+CSTASK_FUTURE getBackgroundExecution(size_t idf);
 /**
  * @brief Joins all threads contained in the given vector.
  * @param threads Vector of threads to execute and join.
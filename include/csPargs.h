@@ -59,6 +59,20 @@ public:
       size_t last;
     }BOUNDS;
 
+    // Etendue d'une tuile : x pour les colonnes, y pour les lignes, z pour les tranches
+    typedef struct
+    {
+      BOUNDS x;
+      BOUNDS y;
+      BOUNDS z;
+    }TILE;
+
+    typedef struct
+    {
+      bool (*claim)(void* ctx, size_t blockId, BOUNDS& chunk);
+      void* ctx;
+    }CHUNK_SOURCE;
+
     CSPARGS(size_t nArgs=0);
 /**
  * @brief Initializes the object.
@@ -76,11 +90,23 @@ public:
  * @param nbArgs Number of arguments.
  */
     void setArgNumber(size_t nbArgs);
+/**
+ * @brief Makes the object use @p storage as argument table instead of its own allocation. Used by the registry to keep
+ * the arguments of all the blocks of a function in one contiguous array. The storage is not freed by clear().
+ * @param storage Table of at least @p nbArgs + 2 pointers.
+ * @param nbArgs Number of arguments.
+ */
+    void setArgStorage(void** storage, size_t nbArgs);
 /**
  * @brief Sets the buffer block bounds.
  * @param bounds Structure CSPARGS::BOUNDS that contains the bounds of the buffer block.
  */
     void setBounds(CSPARGS::BOUNDS bounds);
+/**
+ * @brief Sets the 2D/3D extents of the buffer block.
+ * @param tile Structure CSPARGS::TILE that contains the column (x), row (y) and slice (z) ranges of the block.
+ */
+    void setTile(CSPARGS::TILE tile);
 /**
  * @brief Saves the current block index.
  * @param id Index of the block.
@@ -147,6 +173,12 @@ public:
  * @return CSPARGS::BOUNDS structure that contains the bounds of the buffer block.
  */
     CSPARGS::BOUNDS getBounds();
+/**
+ * @brief Returns the 2D/3D extents of the buffer block. For functions registered with a tile shape (registerFunctionTiled, registerTaskTiled),
+ * x, y and z are the column, row and slice ranges of the tile. For 1D shapes, x holds the block bounds and y, z are {0, 1}.
+ * @return CSPARGS::TILE structure that contains the extents of the buffer block.
+ */
+    CSPARGS::TILE getTile();
 /**
  * @brief Calculates regular bounds of a buffer block from the given @p workSize.
  * @param workSize Global buffer size.
@@ -155,6 +187,19 @@ public:
  */
     void getBounds(size_t workSize, size_t*min, size_t*max);
 
+/**
+ * @brief Returns the next chunk of work handed to the current call. The first call returns getBounds(); the following ones claim new chunks
+ * from the scheduler (CSSCHEDULE_DYNAMIC, CSSCHEDULE_GUIDED, CSSCHEDULE_WORK_STEALING) until the work is exhausted.
+ * With CSSCHEDULE_STATIC, the block bounds are returned once. Typical use: while(args.nextChunk(b)) { ... }
+ * @param chunk Output bounds of the chunk.
+ * @return false when no chunk is left.
+ */
+    bool nextChunk(CSPARGS::BOUNDS& chunk);
+/**
+ * @brief Attaches the scheduler that nextChunk() claims chunks from. Used internally by csParallelTask::execute.
+ * @param source Chunk source, or 0 to only return the block bounds.
+ */
+    void setChunkSource(CSPARGS::CHUNK_SOURCE* source);
 /**
  * @brief Returns the number of registered arguments.
  * @return Number of registered arguments.
@@ -201,9 +246,13 @@ public:
  */
     template<size_t _nbArgs> void regArgs2(void*args[_nbArgs]);
 /**
- * @brief Activates a mutex for safe thread coordination when accessing the same resources.
+ * @brief Locks a mutex shared by all the blocks for safe thread coordination when accessing the same resources.
+ * The returned guard holds the lock until it goes out of scope: keep it in a local variable around the shared access only
+ * (auto lock = args.lockGuard();), and do not execute or wait for other functions while holding it.
+ * For reductions, prefer CSREDUCTION (csReduction.h), which needs no lock.
+ * @return Guard owning the lock.
  */
-    void lockGuard();
+    [[nodiscard]] std::unique_lock<std::mutex> lockGuard();
 /**
  * @brief Releases internal resources associated with this object.
  */
@@ -239,8 +288,12 @@ private:
     size_t blocksNumber;
     size_t blockId;
     BOUNDS bounds;
+    TILE tile;
     size_t workSize;
     size_t delay;
+    CHUNK_SOURCE* chunkSource;
+    size_t chunkCount;
+    bool ownArgs;
 };
 
 #endif
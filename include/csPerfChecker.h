@@ -18,7 +18,9 @@
 #define CSPERF_CHECKER_H
 
 #include <chrono>
+#include <cstdint>
 #include <iostream>
+#include <vector>
 
 #define CSTIME_UNIT_HOUR            0
 #define CSTIME_UNIT_MINUTE          1
@@ -27,14 +29,42 @@
 #define CSTIME_UNIT_MICROSECOND     4
 #define CSTIME_UNIT_NANOSECOND      5
 
+// Portee des compteurs materiels
+#define CSPERF_COUNTERS_OFF         0
+#define CSPERF_COUNTERS_THREAD      1
+#define CSPERF_COUNTERS_WORKERS     2
+
+// Compteurs materiels
+#define CSPERF_CYCLES               0
+#define CSPERF_INSTRUCTIONS         1
+#define CSPERF_LLC_MISSES           2
+#define CSPERF_BRANCH_MISSES        3
+#define CSPERF_STALLED_CYCLES       4
+#define CSPERF_COUNTER_NUMBER       5
+
+typedef struct
+{
+  uint64_t value[CSPERF_COUNTER_NUMBER];
+  bool available[CSPERF_COUNTER_NUMBER];
+  size_t threads;
+}CSPERF_COUNTERS;
+
 class CS_PARALLEL_TASK_API CSPERF_CHECKER
 {
   private:
   std::chrono::time_point<std::chrono::high_resolution_clock>
   strt, stp;
   size_t ellapsed;
+  uint64_t ellapsedNs = 0;
   int unit = CSTIME_UNIT_MICROSECOND;
   mutable const char*unitName = " microseconds\0";
+  int counterMode = CSPERF_COUNTERS_OFF;
+  std::vector<int> counterFds;
+  std::vector<int> counterIds;
+  CSPERF_COUNTERS counters;
+
+  void openCounters();
+  void closeCounters();
 
   public:
 /**
@@ -42,6 +72,12 @@ class CS_PARALLEL_TASK_API CSPERF_CHECKER
  * @param unit Time unit used for measurements (see CSTIME_UNIT_* constants).
  */
   CSPERF_CHECKER(int unit = CSTIME_UNIT_MICROSECOND);
+  ~CSPERF_CHECKER();
+/**
+ * @brief Not copyable: the checker owns its hardware counter descriptors and closes them when destroyed.
+ */
+  CSPERF_CHECKER(const CSPERF_CHECKER&) = delete;
+  CSPERF_CHECKER& operator=(const CSPERF_CHECKER&) = delete;
 /**
  * @brief Sets the time unit used for reporting.
  * @param unit Time unit (see CSTIME_UNIT_* constants).
@@ -65,6 +101,46 @@ class CS_PARALLEL_TASK_API CSPERF_CHECKER
  * @return Execution time in the configured time unit.
  */
   size_t getEllapsedTime();
+/**
+ * @brief Returns the last measured execution time in nanoseconds, whatever the configured unit.
+ * @return Execution time in nanoseconds.
+ */
+  uint64_t getEllapsedNanoseconds();
+/**
+ * @brief Selects the hardware counters read between start() and stop(): cycles, instructions, last level cache misses,
+ * branch misses and stalled backend cycles, counted in user space through perf_event_open on Linux.
+ * With CSPERF_COUNTERS_THREAD only the calling thread is counted; with CSPERF_COUNTERS_WORKERS the calling thread and
+ * every worker of the shared thread pool are counted and summed, which covers the blocks of an execute() call.
+ * When the counters cannot be opened (other systems, perf_event_paranoid, virtual machine) only the time is measured.
+ * @param mode CSPERF_COUNTERS_OFF, CSPERF_COUNTERS_THREAD or CSPERF_COUNTERS_WORKERS.
+ */
+  void setCounterMode(int mode);
+/**
+ * @brief Returns the hardware counters mode.
+ * @return One of the CSPERF_COUNTERS_* constants.
+ */
+  int getCounterMode();
+/**
+ * @brief Tells whether the last measurement read at least one hardware counter.
+ * @return false if the counters are off or unavailable.
+ */
+  bool hasCounters();
+/**
+ * @brief Returns the hardware counters of the last measurement, scaled when the kernel had to multiplex them.
+ * @return Counter values; available[c] is false for the counters that could not be read.
+ */
+  CSPERF_COUNTERS getCounters();
+/**
+ * @brief Returns one hardware counter of the last measurement.
+ * @param counter One of the CSPERF_* counter constants.
+ * @return Counter value, or 0 if it is unavailable.
+ */
+  uint64_t getCounter(int counter);
+/**
+ * @brief Returns the number of instructions per cycle of the last measurement.
+ * @return Instructions per cycle, or 0 if the counters are unavailable.
+ */
+  double getInstructionsPerCycle();
 };
 
 #endif // CSPERF_CHECKER_H
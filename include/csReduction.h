@@ -0,0 +1,183 @@
+#pragma once
+
+#if defined _WIN32 || defined __CYGWIN__
+  #ifdef BUILDING_CSPARALLEL_DLL
+    #define CS_PARALLEL_TASK_API __declspec(dllexport)
+  #else
+    #define CS_PARALLEL_TASK_API __declspec(dllimport)
+  #endif
+#else
+  #ifdef BUILDING_CSPARALLEL_DLL
+    #define CS_PARALLEL_TASK_API __attribute__ ((visibility ("default")))
+  #else
+    #define CS_PARALLEL_TASK_API
+  #endif
+#endif
+
+#ifndef CSREDUCTION_H_INCLUDED
+#define CSREDUCTION_H_INCLUDED
+
+#include <cstddef>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include "csParallel.h"
+
+// Nombre de paires par etage a partir duquel un etage de l'arbre est combine sur le pool
+#define CSREDUCTION_PARALLEL_PAIRS  256
+
+template<class T> T csReduceSum(T a, T b)
+{
+    return a + b;
+}
+
+template<class T> T csReduceProd(T a, T b)
+{
+    return a * b;
+}
+
+template<class T> T csReduceMin(T a, T b)
+{
+    return b < a ? b : a;
+}
+
+template<class T> T csReduceMax(T a, T b)
+{
+    return a < b ? b : a;
+}
+
+template<class T> class CSREDUCTION
+{
+public:
+
+    typedef T(*OPERATOR)(T a, T b);
+
+/**
+ * @brief Constructs a reduction with one slot per buffer block.
+ * @param nBlocks Number of slots, usually csParallelTask::getBlockNumber(idf).
+ * @param identity Neutral element of @p op (0 for a sum, the largest value for a minimum...). Every slot starts with it.
+ * @param op Associative operator used to combine the values (csReduceSum, csReduceProd, csReduceMin, csReduceMax or a custom function).
+ */
+    CSREDUCTION(size_t nBlocks=0, T identity=T(), OPERATOR op=csReduceSum<T>)
+    {
+        init(nBlocks, identity, op);
+    };
+/**
+ * @brief Resizes the reduction and sets its operator. Every slot is reset to @p identity.
+ * @param nBlocks Number of slots.
+ * @param identity Neutral element of @p op.
+ * @param op Associative operator.
+ */
+    void init(size_t nBlocks, T identity, OPERATOR op)
+    {
+        identityValue = identity;
+        reduceOp = op;
+        slots.resize(nBlocks);
+        tree.resize(nBlocks);
+        reset();
+    };
+/**
+ * @brief Resets every slot to the identity. Call it before each execution that reuses the reduction.
+ */
+    void reset()
+    {
+        size_t n = slots.size();
+        for(size_t i=0; i<n; i++)
+        {
+            slots[i].value = identityValue;
+        }
+    };
+/**
+ * @brief Combines @p value into the slot of the block @p blockId. Each block only writes its own slot, so no lock is needed.
+ * Can be called several times per block, e.g. once per chunk with the dynamic schedules.
+ * @param blockId Index of the block (CSPARGS::getBlockId()).
+ * @param value Partial result of the block.
+ */
+    void accumulate(size_t blockId, T value)
+    {
+        slots[blockId].value = reduceOp(slots[blockId].value, value);
+    };
+/**
+ * @brief Returns a reference to the slot of the block @p blockId, for kernels that update their partial result in place.
+ * @param blockId Index of the block.
+ * @return Slot value.
+ */
+    T& slot(size_t blockId)
+    {
+        return slots[blockId].value;
+    };
+/**
+ * @brief Combines all the slots once the blocks are done. Pairs of slots are combined level by level (pairwise tree),
+ * which keeps the order of the operations independent of the thread timing; wide levels are spread over the worker pool.
+ * The slots are left untouched.
+ * @return Reduced value, or the identity if there is no slot.
+ */
+    T combine()
+    {
+        size_t n = slots.size();
+        if (n == 0)
+            return identityValue;
+
+        for(size_t i=0; i<n; i++)
+        {
+            tree[i].value = slots[i].value;
+        }
+
+        for(stride=1; stride<n; stride*=2)
+        {
+            size_t nPairs = (n - stride + 2*stride - 1)/(2*stride);
+            if (nPairs >= CSREDUCTION_PARALLEL_PAIRS)
+            {
+                CSTHREAD_POOL* pool = csParallelTask::getThreadPool();
+                nTasks = std::min(nPairs/CSREDUCTION_PARALLEL_PAIRS, pool->getWorkerNumber() + 1);
+                pool->run(nTasks, combineLevel, this);
+            }
+            else
+            {
+                nTasks = 1;
+                combineLevel(this, 0);
+            }
+        }
+        return tree[0].value;
+    };
+/**
+ * @brief Returns the number of slots.
+ * @return Number of slots.
+ */
+    size_t getSlotNumber()
+    {
+        return slots.size();
+    };
+
+private:
+    // Un emplacement par ligne de cache : les blocs voisins n'ecrivent jamais sur la meme ligne
+    typedef struct alignas(64)
+    {
+        T value;
+    }SLOT;
+
+    static void combineLevel(void* ctx, size_t task)
+    {
+        CSREDUCTION<T>* r = (CSREDUCTION<T>*)ctx;
+        size_t n = r->tree.size();
+        size_t step = 2*r->stride;
+        size_t nPairs = (n - r->stride + step - 1)/step;
+        size_t first = task*nPairs/r->nTasks;
+        size_t last = (task+1)*nPairs/r->nTasks;
+
+        for(size_t p=first; p<last; p++)
+        {
+            size_t i = p*step;
+            r->tree[i].value = r->reduceOp(r->tree[i].value, r->tree[i + r->stride].value);
+        }
+    };
+
+    std::vector<SLOT> slots;
+    std::vector<SLOT> tree;
+    T identityValue;
+    OPERATOR reduceOp;
+    size_t stride;
+    size_t nTasks;
+};
+
+#endif // CSREDUCTION_H_INCLUDED
@@ -0,0 +1,165 @@
+#pragma once
+
+#if defined _WIN32 || defined __CYGWIN__
+  #ifdef BUILDING_CSPARALLEL_DLL
+    #define CS_PARALLEL_TASK_API __declspec(dllexport)
+  #else
+    #define CS_PARALLEL_TASK_API __declspec(dllimport)
+  #endif
+#else
+  #ifdef BUILDING_CSPARALLEL_DLL
+    #define CS_PARALLEL_TASK_API __attribute__ ((visibility ("default")))
+  #else
+    #define CS_PARALLEL_TASK_API
+  #endif
+#endif
+
+#ifndef CSSIMD_H_INCLUDED
+#define CSSIMD_H_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+
+#define CSSIMD_SCALAR   0
+#define CSSIMD_SSE2     1
+#define CSSIMD_AVX2     2
+#define CSSIMD_AVX512   3
+
+// Taille des blocs de simdArgMin / simdArgMax : le bloc qui contient le resultat est parcouru une seconde fois
+#define CSSIMD_ARG_BLOCK  2048
+
+namespace csParallelTask
+{
+
+/**
+ * @brief Returns the best instruction set the CPU (CPUID, with operating system support of the registers) and the library build both support.
+ * CSSIMD_AVX2 requires AVX2 and FMA, CSSIMD_AVX512 requires AVX-512F.
+ * @return CSSIMD_SCALAR, CSSIMD_SSE2, CSSIMD_AVX2 or CSSIMD_AVX512.
+ */
+int getCpuSimdLevel();
+/**
+ * @brief Selects the instruction set of the simd* kernels. By default, getCpuSimdLevel() is used.
+ * @param level CSSIMD_SCALAR to CSSIMD_AVX512.
+ * @return false if @p level is above getCpuSimdLevel() (the selection is then unchanged).
+ */
+bool setSimdLevel(int level);
+/**
+ * @brief Returns the instruction set used by the simd* kernels.
+ * @return CSSIMD_SCALAR, CSSIMD_SSE2, CSSIMD_AVX2 or CSSIMD_AVX512.
+ */
+int getSimdLevel();
+/**
+ * @brief Returns the name of an instruction set level ("scalar", "sse2", "avx2", "avx512").
+ * @param level CSSIMD_SCALAR to CSSIMD_AVX512.
+ * @return Name of the level.
+ */
+const char* getSimdLevelName(int level);
+
+/**
+ * @brief Sum of @p x[0..n). The vector paths use several accumulators, so the rounding differs from a sequential loop.
+ * The int32 version accumulates in 64 bits.
+ * @param x Data.
+ * @param n Number of elements.
+ * @return Sum (0 if @p n is 0).
+ */
+double simdSum(const double* x, size_t n);
+float simdSum(const float* x, size_t n);
+int64_t simdSum(const int32_t* x, size_t n);
+/**
+ * @brief Kahan-compensated sum of @p x[0..n): each vector lane carries its own compensation, the lanes are merged with a compensated sum.
+ * The error does not grow with @p n, which makes float sums of large arrays usable.
+ * @param x Data.
+ * @param n Number of elements.
+ * @return Sum (0 if @p n is 0).
+ */
+double simdKahanSum(const double* x, size_t n);
+float simdKahanSum(const float* x, size_t n);
+/**
+ * @brief Sum of the squares of @p x[0..n) (squared Euclidean norm).
+ * @param x Data.
+ * @param n Number of elements.
+ * @return Sum of squares (0 if @p n is 0).
+ */
+double simdSumSquares(const double* x, size_t n);
+float simdSumSquares(const float* x, size_t n);
+/**
+ * @brief Dot product of @p x[0..n) and @p y[0..n). The int32 version accumulates the 64-bit products.
+ * @param x First vector.
+ * @param y Second vector.
+ * @param n Number of elements.
+ * @return Dot product (0 if @p n is 0).
+ */
+double simdDot(const double* x, const double* y, size_t n);
+float simdDot(const float* x, const float* y, size_t n);
+int64_t simdDot(const int32_t* x, const int32_t* y, size_t n);
+/**
+ * @brief Smallest value of @p x[0..n). NaN values are not supported.
+ * @param x Data.
+ * @param n Number of elements.
+ * @return Smallest value (the largest value of the type if @p n is 0).
+ */
+double simdMin(const double* x, size_t n);
+float simdMin(const float* x, size_t n);
+int32_t simdMin(const int32_t* x, size_t n);
+/**
+ * @brief Largest value of @p x[0..n). NaN values are not supported.
+ * @param x Data.
+ * @param n Number of elements.
+ * @return Largest value (the lowest value of the type if @p n is 0).
+ */
+double simdMax(const double* x, size_t n);
+float simdMax(const float* x, size_t n);
+int32_t simdMax(const int32_t* x, size_t n);
+/**
+ * @brief Index of the first smallest value of @p x[0..n), like std::min_element. The minimum of each block of CSSIMD_ARG_BLOCK elements
+ * is computed with the vector kernel; only the block holding the result is scanned again.
+ * If @p x holds a NaN, the index of the first NaN is returned.
+ * @param x Data.
+ * @param n Number of elements.
+ * @return Index of the first smallest value, or of the first NaN (@p n if @p n is 0).
+ */
+size_t simdArgMin(const double* x, size_t n);
+size_t simdArgMin(const float* x, size_t n);
+size_t simdArgMin(const int32_t* x, size_t n);
+/**
+ * @brief Index of the first largest value of @p x[0..n), like std::max_element.
+ * If @p x holds a NaN, the index of the first NaN is returned.
+ * @param x Data.
+ * @param n Number of elements.
+ * @return Index of the first largest value, or of the first NaN (@p n if @p n is 0).
+ */
+size_t simdArgMax(const double* x, size_t n);
+size_t simdArgMax(const float* x, size_t n);
+size_t simdArgMax(const int32_t* x, size_t n);
+/**
+ * @brief y = a*x + y on @p n elements (fused multiply-add on the AVX2 and AVX-512 paths). The int32 version wraps around on overflow.
+ * @param a Factor.
+ * @param x Input vector.
+ * @param y Input and output vector.
+ * @param n Number of elements.
+ */
+void simdAxpy(double a, const double* x, double* y, size_t n);
+void simdAxpy(float a, const float* x, float* y, size_t n);
+void simdAxpy(int32_t a, const int32_t* x, int32_t* y, size_t n);
+/**
+ * @brief x = a*x on @p n elements. The int32 version wraps around on overflow.
+ * @param x Input and output vector.
+ * @param n Number of elements.
+ * @param a Factor.
+ */
+void simdScale(double* x, size_t n, double a);
+void simdScale(float* x, size_t n, float a);
+void simdScale(int32_t* x, size_t n, int32_t a);
+/**
+ * @brief Sets the @p n elements of @p x to @p value.
+ * @param x Output vector.
+ * @param n Number of elements.
+ * @param value Value.
+ */
+void simdFill(double* x, size_t n, double value);
+void simdFill(float* x, size_t n, float value);
+void simdFill(int32_t* x, size_t n, int32_t value);
+
+}
+
+#endif // CSSIMD_H_INCLUDED
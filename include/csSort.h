@@ -0,0 +1,185 @@
+#pragma once
+
+#if defined _WIN32 || defined __CYGWIN__
+  #ifdef BUILDING_CSPARALLEL_DLL
+    #define CS_PARALLEL_TASK_API __declspec(dllexport)
+  #else
+    #define CS_PARALLEL_TASK_API __declspec(dllimport)
+  #endif
+#else
+  #ifdef BUILDING_CSPARALLEL_DLL
+    #define CS_PARALLEL_TASK_API __attribute__ ((visibility ("default")))
+  #else
+    #define CS_PARALLEL_TASK_API
+  #endif
+#endif
+
+#ifndef CSSORT_H_INCLUDED
+#define CSSORT_H_INCLUDED
+
+#include <cstddef>
+#include <vector>
+#include <iterator>
+#include <algorithm>
+#include <functional>
+#include <random>
+#include "csAlgorithm.h"
+
+// En dessous de cette taille, le tri sequentiel est plus rapide que la repartition
+#define CSSORT_SEQUENTIAL_SIZE    16384
+// Nombre de seaux par tache : des seaux plus petits equilibrent mieux la derniere phase
+#define CSSORT_BUCKETS_PER_TASK   4
+// Nombre d'echantillons par seau pour choisir les separateurs
+#define CSSORT_OVERSAMPLING       32
+
+namespace csParallelTask
+{
+
+/**
+ * @brief Sample sort of [@p first, @p last) on the shared worker pool. Used by parallel_sort() and parallel_stable_sort().
+ * 1. Splitters are chosen from a sorted random sample (fixed seed), which cuts the key space into buckets of similar sizes.
+ *    A key that fills several buckets of the sample appears as several equal splitters; the elements equivalent to it are spread
+ *    over the buckets between those splitters by position, so heavy duplicates do not end up in a single bucket.
+ * 2. Each task counts the elements of its contiguous part per bucket; the counts give every (part, bucket) pair its output position.
+ * 3. Each task moves its elements to their bucket in a temporary buffer, keeping their order.
+ * 4. The buckets are sorted independently and moved back in place, in parallel: the buckets are already in their final order, so there is no merge.
+ * @param first Random-access iterator to the first element.
+ * @param last Iterator following the last element.
+ * @param comp Strict weak ordering.
+ * @param stable true to keep the order of equivalent elements.
+ */
+template<class It, class C> void parallel_sample_sort(It first, It last, C comp, bool stable)
+{
+    typedef typename std::iterator_traits<It>::value_type T;
+    size_t n = last - first;
+    size_t nTasks = getAlgorithmTaskNumber(n, CSSORT_SEQUENTIAL_SIZE);
+    if (nTasks == 1)
+    {
+        if (stable)
+            std::stable_sort(first, last, comp);
+        else
+            std::sort(first, last, comp);
+        return;
+    }
+
+    size_t nParts = nTasks;
+    size_t nBuckets = nTasks*CSSORT_BUCKETS_PER_TASK;
+
+    // Separateurs : nBuckets-1 valeurs regulierement espacees dans un echantillon trie
+    std::vector<T> splitters;
+    {
+        std::vector<T> sample;
+        size_t nSamples = nBuckets*CSSORT_OVERSAMPLING;
+        std::minstd_rand rng((unsigned)n);
+        std::uniform_int_distribution<size_t> pick(0, n-1);
+        sample.reserve(nSamples);
+        for(size_t s=0; s<nSamples; s++)
+            sample.push_back(first[pick(rng)]);
+        std::sort(sample.begin(), sample.end(), comp);
+        for(size_t b=1; b<nBuckets; b++)
+            splitters.push_back(sample[b*CSSORT_OVERSAMPLING]);
+    }
+    // Seau de l'element d'indice i. Un element equivalent a une suite de separateurs egaux s[lo..hi-1] peut aller dans
+    // les seaux lo+1..hi : il est reparti selon sa position, ce qui garde l'ordre des elements equivalents (tri stable)
+    auto bucketOf = [&](const T& v, size_t i) -> size_t
+    {
+        size_t hi = std::upper_bound(splitters.begin(), splitters.end(), v, comp) - splitters.begin();
+        if (hi == 0 || comp(splitters[hi-1], v))
+            return hi;
+        size_t lo = std::lower_bound(splitters.begin(), splitters.begin() + hi, v, comp) - splitters.begin();
+        return lo + 1 + i*(hi - lo)/n;
+    };
+    auto partFirst = [&](size_t part) -> size_t
+    {
+        return part*n/nParts;
+    };
+
+    // counts[part*nBuckets + bucket] devient la position de sortie du couple (part, seau)
+    std::vector<size_t> counts(nParts*nBuckets, 0);
+    parallel_for(0, nParts, [&](size_t part)
+    {
+        size_t* c = &counts[part*nBuckets];
+        for(size_t i=partFirst(part); i<partFirst(part+1); i++)
+            c[bucketOf(first[i], i)]++;
+    }, 1);
+
+    std::vector<size_t> bucketStart(nBuckets+1, 0);
+    size_t pos = 0;
+    for(size_t b=0; b<nBuckets; b++)
+    {
+        bucketStart[b] = pos;
+        for(size_t part=0; part<nParts; part++)
+        {
+            size_t c = counts[part*nBuckets + b];
+            counts[part*nBuckets + b] = pos;
+            pos += c;
+        }
+    }
+    bucketStart[nBuckets] = n;
+
+    std::vector<T> buffer(n);
+    parallel_for(0, nParts, [&](size_t part)
+    {
+        size_t* out = &counts[part*nBuckets];
+        for(size_t i=partFirst(part); i<partFirst(part+1); i++)
+        {
+            size_t b = bucketOf(first[i], i);
+            buffer[out[b]++] = std::move(first[i]);
+        }
+    }, 1);
+
+    parallel_for(0, nBuckets, [&](size_t b)
+    {
+        typename std::vector<T>::iterator bFirst = buffer.begin() + bucketStart[b];
+        typename std::vector<T>::iterator bLast = buffer.begin() + bucketStart[b+1];
+        if (stable)
+            std::stable_sort(bFirst, bLast, comp);
+        else
+            std::sort(bFirst, bLast, comp);
+        std::move(bFirst, bLast, first + bucketStart[b]);
+    }, 1);
+};
+/**
+ * @brief Sorts [@p first, @p last) in parallel with @p comp (sample sort, see parallel_sample_sort()). The order of equivalent elements is not kept.
+ * Ranges smaller than CSSORT_SEQUENTIAL_SIZE are sorted with std::sort on the calling thread.
+ * The elements must be default-constructible and movable; a temporary buffer of the size of the range is allocated.
+ * @param first Random-access iterator (or pointer) to the first element.
+ * @param last Iterator following the last element.
+ * @param comp Strict weak ordering.
+ */
+template<class It, class C> void parallel_sort(It first, It last, C comp)
+{
+    parallel_sample_sort(first, last, comp, false);
+};
+/**
+ * @brief Sorts [@p first, @p last) in ascending order (operator<) in parallel.
+ * @param first Random-access iterator (or pointer) to the first element.
+ * @param last Iterator following the last element.
+ */
+template<class It> void parallel_sort(It first, It last)
+{
+    parallel_sample_sort(first, last, std::less<typename std::iterator_traits<It>::value_type>(), false);
+};
+/**
+ * @brief Sorts [@p first, @p last) in parallel with @p comp, keeping the order of equivalent elements (like std::stable_sort).
+ * @param first Random-access iterator (or pointer) to the first element.
+ * @param last Iterator following the last element.
+ * @param comp Strict weak ordering.
+ */
+template<class It, class C> void parallel_stable_sort(It first, It last, C comp)
+{
+    parallel_sample_sort(first, last, comp, true);
+};
+/**
+ * @brief Sorts [@p first, @p last) in ascending order (operator<) in parallel, keeping the order of equal elements.
+ * @param first Random-access iterator (or pointer) to the first element.
+ * @param last Iterator following the last element.
+ */
+template<class It> void parallel_stable_sort(It first, It last)
+{
+    parallel_sample_sort(first, last, std::less<typename std::iterator_traits<It>::value_type>(), true);
+};
+
+}
+
+#endif // CSSORT_H_INCLUDED
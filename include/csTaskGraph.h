@@ -0,0 +1,80 @@
+#pragma once
+
+#if defined _WIN32 || defined __CYGWIN__
+  #ifdef BUILDING_CSPARALLEL_DLL
+    #define CS_PARALLEL_TASK_API __declspec(dllexport)
+  #else
+    #define CS_PARALLEL_TASK_API __declspec(dllimport)
+  #endif
+#else
+  #ifdef BUILDING_CSPARALLEL_DLL
+    #define CS_PARALLEL_TASK_API __attribute__ ((visibility ("default")))
+  #else
+    #define CS_PARALLEL_TASK_API
+  #endif
+#endif
+
+#ifndef CSTASK_GRAPH_H_INCLUDED
+#define CSTASK_GRAPH_H_INCLUDED
+
+#include <cstddef>
+#include <vector>
+#include "csThreadPool.h"
+
+#define CSDEPENDENCY_TASK     0
+#define CSDEPENDENCY_BLOCK    1
+
+class CS_PARALLEL_TASK_API CSTASK_GRAPH
+{
+public:
+
+    typedef struct
+    {
+        size_t before;
+        size_t after;
+        int mode;
+    }DEPENDENCY;
+
+    CSTASK_GRAPH();
+/**
+ * @brief Adds the registered function @p idf to the graph. Functions used in addDependency() are added automatically.
+ * @param idf Index of the function.
+ */
+    void addTask(size_t idf);
+/**
+ * @brief Declares that the function @p idfAfter depends on the function @p idfBefore.
+ * @param idfBefore Index of the upstream function.
+ * @param idfAfter Index of the downstream function.
+ * @param mode CSDEPENDENCY_TASK: every block of @p idfAfter waits for all the blocks of @p idfBefore.
+ * CSDEPENDENCY_BLOCK: block i of @p idfAfter only waits for block i of @p idfBefore. Requires both functions to use
+ * CSSCHEDULE_STATIC with the same number of blocks; otherwise the dependency is handled as CSDEPENDENCY_TASK.
+ */
+    void addDependency(size_t idfBefore, size_t idfAfter, int mode = CSDEPENDENCY_TASK);
+/**
+ * @brief Runs every function of the graph on the worker pool, each block starting as soon as its dependencies are done, and waits for the whole graph.
+ */
+    void execute();
+/**
+ * @brief Starts the graph on the worker pool and returns without waiting.
+ * @return Future completed when every block of the graph has run.
+ */
+    CSTASK_FUTURE executeAsync();
+/**
+ * @brief Removes all the functions and dependencies of the graph. The registered functions are left untouched.
+ */
+    void clear();
+/**
+ * @brief Returns the number of functions in the graph.
+ * @return Number of functions.
+ */
+    size_t getTaskNumber();
+
+private:
+    size_t findTask(size_t idf);
+    bool sortTasks(std::vector<size_t>& order);
+
+    std::vector<size_t> tasks;
+    std::vector<DEPENDENCY> dependencies;
+};
+
+#endif // CSTASK_GRAPH_H_INCLUDED
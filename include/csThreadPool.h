@@ -0,0 +1,234 @@
+#pragma once
+
+#if defined _WIN32 || defined __CYGWIN__
+  #ifdef BUILDING_CSPARALLEL_DLL
+    #define CS_PARALLEL_TASK_API __declspec(dllexport)
+  #else
+    #define CS_PARALLEL_TASK_API __declspec(dllimport)
+  #endif
+#else
+  #ifdef BUILDING_CSPARALLEL_DLL
+    #define CS_PARALLEL_TASK_API __attribute__ ((visibility ("default")))
+  #else
+    #define CS_PARALLEL_TASK_API
+  #endif
+#endif
+
+#ifndef CSTHREAD_POOL_H_INCLUDED
+#define CSTHREAD_POOL_H_INCLUDED
+
+#include <cstddef>
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "csPerfChecker.h"
+
+class CS_PARALLEL_TASK_API CSTHREAD_POOL
+{
+public:
+
+    typedef void(*TASK_FUNC)(void* ctx, size_t i);
+
+    typedef struct
+    {
+        std::atomic<size_t> pending;
+        std::atomic<size_t> refs;
+    }TASK_GROUP;
+
+    typedef struct
+    {
+        TASK_FUNC func;
+        void* ctx;
+        size_t index;
+        TASK_GROUP* group;
+    }TASK;
+
+    static const size_t NO_CPU = (size_t)-1;
+    static const size_t NO_WORKER = (size_t)-1;
+
+/**
+ * @brief Constructs a pool and starts @p nWorkers worker threads.
+ * @param nWorkers Number of worker threads. No thread is created if 0.
+ */
+    CSTHREAD_POOL(size_t nWorkers=0);
+/**
+ * @brief Stops and joins all worker threads.
+ */
+    ~CSTHREAD_POOL();
+/**
+ * @brief Starts @p nWorkers worker threads. Running workers are stopped first.
+ * @param nWorkers Number of worker threads.
+ */
+    void start(size_t nWorkers);
+/**
+ * @brief Waits for the queued tasks to be processed, then stops and joins all worker threads.
+ */
+    void stop();
+/**
+ * @brief Returns the number of worker threads.
+ * @return Number of worker threads.
+ */
+    size_t getWorkerNumber();
+/**
+ * @brief Tells whether the calling thread is one of the workers of a pool.
+ * @return true if called from a worker thread.
+ */
+    static bool isWorkerThread();
+/**
+ * @brief Returns the index of the calling worker in its pool.
+ * @return Index of the worker, or CSTHREAD_POOL::NO_WORKER if the calling thread is not a worker.
+ */
+    static size_t getWorkerIndex();
+/**
+ * @brief Returns the system thread id of worker @p worker (the Linux TID), e.g. to attach hardware counters to it.
+ * @param worker Index of the worker.
+ * @return Thread id, or 0 if the worker does not exist or the system has no such id.
+ */
+    size_t getWorkerSystemId(size_t worker);
+/**
+ * @brief Binds worker w to the CPU @p cpus[w % cpus.size()]. The binding is kept when the pool is restarted.
+ * @param cpus List of CPU numbers; an empty list lets the workers run on any available CPU again.
+ */
+    void setAffinity(const std::vector<size_t>& cpus);
+/**
+ * @brief Returns the CPU worker @p worker is bound to.
+ * @param worker Index of the worker.
+ * @return CPU number, or CSTHREAD_POOL::NO_CPU if the worker is not bound.
+ */
+    size_t getWorkerCpu(size_t worker);
+/**
+ * @brief Returns the first worker bound to the CPU @p cpu.
+ * @param cpu CPU number.
+ * @return Index of the worker, or CSTHREAD_POOL::NO_CPU if no worker is bound to this CPU.
+ */
+    size_t getWorkerOnCpu(size_t cpu);
+/**
+ * @brief Queues the task @p index of @p func on the private queue of worker @p worker: only this worker runs it.
+ * @param worker Index of the worker (taken modulo the number of workers).
+ * @param index Index of the task.
+ * @param func Function executed by the task.
+ * @param ctx Context pointer passed to @p func.
+ * @param group Completion group, or 0 to run detached.
+ */
+    void submitTo(size_t worker, size_t index, TASK_FUNC func, void* ctx, TASK_GROUP* group);
+/**
+ * @brief Queues the tasks @p first to @p last-1 of @p func. Each task receives @p ctx and its own index.
+ * @param first Index of the first task.
+ * @param last Index following the last task.
+ * @param func Function executed by each task.
+ * @param ctx Context pointer passed to @p func.
+ * @param group Completion group whose pending counter is decremented after each task, or 0 to run detached.
+ */
+    void submit(size_t first, size_t last, TASK_FUNC func, void* ctx, TASK_GROUP* group);
+/**
+ * @brief Blocks until every task of @p group has completed. Called from a worker of this pool (nested parallelism),
+ * the worker keeps executing queued tasks while it waits instead of blocking.
+ * @param group Completion group.
+ */
+    void wait(TASK_GROUP* group);
+/**
+ * @brief Blocks until every task of @p group has completed or @p timeoutNs nanoseconds have elapsed.
+ * @param group Completion group.
+ * @param timeoutNs Maximum waiting time in nanoseconds.
+ * @return true if all the tasks have completed.
+ */
+    bool wait(TASK_GROUP* group, size_t timeoutNs);
+/**
+ * @brief Marks one task of @p group as completed without running it through the pool. Used for work accounted outside submit().
+ * @param group Completion group.
+ */
+    void complete(TASK_GROUP* group);
+/**
+ * @brief Allocates a reference-counted completion group. The group is freed once its owner has released it and its tasks are done.
+ * A group allocated on the stack (refs = 0) is never freed by the pool.
+ * @param pending Number of tasks that will be submitted with the group.
+ * @return Group owned by the caller.
+ */
+    static TASK_GROUP* createGroup(size_t pending);
+/**
+ * @brief Adds a reference to a group created by createGroup().
+ * @param group Completion group.
+ */
+    static void retainGroup(TASK_GROUP* group);
+/**
+ * @brief Releases a reference to a group created by createGroup().
+ * @param group Completion group.
+ */
+    static void releaseGroup(TASK_GROUP* group);
+/**
+ * @brief Runs @p nTasks tasks of @p func and returns once all of them are done. Task 0 is run by the calling thread.
+ * @param nTasks Number of tasks.
+ * @param func Function executed by each task.
+ * @param ctx Context pointer passed to @p func.
+ */
+    void run(size_t nTasks, TASK_FUNC func, void* ctx);
+
+private:
+    void workerLoop(size_t worker);
+    bool pop(size_t worker, TASK& task);
+    void runTask(TASK& task);
+    void help(TASK_GROUP* group);
+    void applyAffinity();
+
+    std::vector<std::thread> workers;
+    std::deque<TASK> queue;
+    std::vector<std::deque<TASK>> localQueues;
+    std::vector<size_t> affinity;
+    std::vector<size_t> systemIds;
+    size_t startedWorkers;
+    std::mutex queueMutex;
+    std::condition_variable queueCv;
+    std::mutex doneMutex;
+    std::condition_variable doneCv;
+    std::atomic<size_t> queued;
+    size_t sleepers;
+    bool stopping;
+};
+
+class CS_PARALLEL_TASK_API CSTASK_FUTURE
+{
+public:
+/**
+ * @brief Constructs an empty future, considered as already completed.
+ */
+    CSTASK_FUTURE();
+/**
+ * @brief Constructs a future over a completion group. The future takes over one reference of @p group.
+ * @param pool Pool running the tasks of the group.
+ * @param group Group created by CSTHREAD_POOL::createGroup().
+ */
+    CSTASK_FUTURE(CSTHREAD_POOL* pool, CSTHREAD_POOL::TASK_GROUP* group);
+    CSTASK_FUTURE(const CSTASK_FUTURE& future);
+    CSTASK_FUTURE& operator=(const CSTASK_FUTURE& future);
+    ~CSTASK_FUTURE();
+/**
+ * @brief Blocks until the execution is complete.
+ */
+    void wait();
+/**
+ * @brief Blocks until the execution is complete or @p timeout has elapsed.
+ * @param timeout Maximum waiting time.
+ * @param unit Time unit of @p timeout (see CSTIME_UNIT_* constants).
+ * @return true if the execution is complete.
+ */
+    bool waitFor(size_t timeout, int unit = CSTIME_UNIT_MILLISECOND);
+/**
+ * @brief Tells without blocking whether the execution is complete.
+ * @return true if the execution is complete.
+ */
+    bool poll();
+/**
+ * @brief Tells whether the future is attached to an execution.
+ * @return true if the future was returned by an execution.
+ */
+    bool isValid();
+
+private:
+    CSTHREAD_POOL* pool;
+    CSTHREAD_POOL::TASK_GROUP* group;
+};
+
+#endif // CSTHREAD_POOL_H_INCLUDED
@@ -0,0 +1,73 @@
+#pragma once
+
+#if defined _WIN32 || defined __CYGWIN__
+  #ifdef BUILDING_CSPARALLEL_DLL
+    #define CS_PARALLEL_TASK_API __declspec(dllexport)
+  #else
+    #define CS_PARALLEL_TASK_API __declspec(dllimport)
+  #endif
+#else
+  #ifdef BUILDING_CSPARALLEL_DLL
+    #define CS_PARALLEL_TASK_API __attribute__ ((visibility ("default")))
+  #else
+    #define CS_PARALLEL_TASK_API
+  #endif
+#endif
+
+#ifndef CSTRACE_H_INCLUDED
+#define CSTRACE_H_INCLUDED
+
+#include <cstddef>
+
+// Nombre d'evenements gardes par thread (puissance de deux) : au-dela, les plus anciens sont ecrases
+#define CSTRACE_BUFFER_SIZE   65536
+
+namespace csParallelTask
+{
+
+/**
+ * @brief Enables or disables the tracing of the executions. While enabled, every thread records into its own ring buffer
+ * (written without locks): begin and end of each execute() call and of each block with the name of the function, launches of
+ * executeAsync() and task graphs, wake-ups of the pool workers and steals of the work stealing mode.
+ * Disabled, the cost is one atomic read per block. Changing the buffer size drops the recorded events; it is safe while functions run.
+ * @param enable true to enable, false to disable.
+ * @param eventsPerThread Capacity of each ring buffer, rounded up to a power of two; the oldest events are overwritten.
+ */
+void setTracing(bool enable, size_t eventsPerThread = CSTRACE_BUFFER_SIZE);
+/**
+ * @brief Returns whether the tracing is enabled.
+ * @return true if enabled.
+ */
+bool getTracing();
+/**
+ * @brief Writes the recorded events as Chrome trace-event JSON, to open in Perfetto (ui.perfetto.dev) or chrome://tracing.
+ * Each thread is a track named after its pool worker; time is in microseconds since the tracing was enabled or cleared.
+ * Call it while no function is executing.
+ * @param path Output file.
+ * @return false if the file cannot be written.
+ */
+bool dumpTrace(const char* path);
+/**
+ * @brief Drops the recorded events and restarts the time origin. An event being written during the call may be kept.
+ */
+void clearTrace();
+/**
+ * @brief Opens a user span on the calling thread, e.g. a stage of a pipeline. The name is copied. Each thread caches the names
+ * it has already used by address, so repeated calls with the same string take no lock.
+ * @param name Name of the span.
+ */
+void traceBegin(const char* name);
+/**
+ * @brief Closes the last span opened by traceBegin() on the calling thread.
+ * @param name Name of the span.
+ */
+void traceEnd(const char* name);
+/**
+ * @brief Records an instant event on the calling thread.
+ * @param name Name of the event.
+ */
+void traceMark(const char* name);
+
+}
+
+#endif // CSTRACE_H_INCLUDED
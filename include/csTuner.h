@@ -0,0 +1,103 @@
+#pragma once
+
+#if defined _WIN32 || defined __CYGWIN__
+  #ifdef BUILDING_CSPARALLEL_DLL
+    #define CS_PARALLEL_TASK_API __declspec(dllexport)
+  #else
+    #define CS_PARALLEL_TASK_API __declspec(dllimport)
+  #endif
+#else
+  #ifdef BUILDING_CSPARALLEL_DLL
+    #define CS_PARALLEL_TASK_API __attribute__ ((visibility ("default")))
+  #else
+    #define CS_PARALLEL_TASK_API
+  #endif
+#endif
+
+#ifndef CSTUNER_H_INCLUDED
+#define CSTUNER_H_INCLUDED
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Variable d'environnement : fichier de profil lu au chargement de la bibliotheque
+#define CSTUNE_PROFILE_ENV    "CSPARALLEL_TUNE_PROFILE"
+
+// Nombre d'executions mesurees par configuration essayee (le meilleur temps est retenu)
+#define CSTUNE_REPETITIONS    3
+
+// Meilleure configuration d'une fonction pour une tranche de taille [2^sizeBucket, 2^(sizeBucket+1))
+typedef struct
+{
+  std::string name;
+  size_t sizeBucket;
+  size_t nBlocks;
+  int schedule;
+  size_t chunkSize;
+  double time;
+}CSTUNE_ENTRY;
+
+namespace csParallelTask
+{
+
+/**
+ * @brief Returns the size bucket of @p workSize used as profile key: floor(log2(workSize)), 0 for 0 and 1.
+ * @param workSize Total buffer size.
+ * @return Size bucket.
+ */
+size_t getSizeBucket(size_t workSize);
+/**
+ * @brief Runs the function @p idf with several block counts (powers of two below its current block number, or below @p maxBlocks,
+ * and that bound itself) and scheduling modes (static, dynamic with chunks of workSize/(4, 16 and 64 x nBlocks), work stealing), keeps the fastest one,
+ * applies it to the function and records it in the profile under the name of the function and the size bucket of its work size.
+ * Each configuration is run once to warm up, then @p repetitions times; the minimum time is kept.
+ * By default the block number never grows, so buffers sized with getBlockNumber() (CSREDUCTION...) stay valid. A larger
+ * @p maxBlocks (capped at getAvailableConcurrency()) lets a function registered with few blocks use a larger node; the caller
+ * then resizes its per-block buffers from getBlockNumber() after the call. A function whose blocks are not regular
+ * (custom or cost-weighted shape) keeps its block number and shape; only its scheduling mode is tuned.
+ * The function is executed many times: its result must not depend on the number of runs (no in-place accumulation).
+ * Tiled functions cannot be tuned. Nothing is tuned unless this function is called.
+ * @param idf Index of the function.
+ * @param repetitions Number of timed runs per configuration.
+ * @param maxBlocks Largest block number tried; 0 or a value below the current block number keeps the current one as the limit.
+ * @return Best configuration (nBlocks is 0 if the function could not be tuned).
+ */
+CSTUNE_ENTRY tuneFunction(size_t idf, size_t repetitions = CSTUNE_REPETITIONS, size_t maxBlocks = 0);
+/**
+ * @brief Loads a profile file and merges its entries into the current profile, replacing the entries with the same key.
+ * Functions registered afterwards get the matching entries (see applyTuningProfile()). The file named by
+ * CSPARALLEL_TUNE_PROFILE is read when the library is loaded, before any explicit load, so explicit loads take precedence.
+ * @param path Profile file.
+ * @return false if the file cannot be read.
+ */
+bool loadTuningProfile(const char* path);
+/**
+ * @brief Writes the current profile to a text file, one entry per line: size bucket, block number, scheduling mode, chunk size,
+ * time in nanoseconds and function name.
+ * @param path Profile file.
+ * @return false if the file cannot be written.
+ */
+bool saveTuningProfile(const char* path);
+/**
+ * @brief Returns the entries of the current profile.
+ * @return Entries sorted by function name and size bucket.
+ */
+std::vector<CSTUNE_ENTRY> getTuningProfile();
+/**
+ * @brief Removes all the entries of the current profile.
+ */
+void clearTuningProfile();
+/**
+ * @brief Applies the profile entry matching the name and work size of the function @p idf, if any: scheduling mode and chunk size,
+ * and the block number if it is lower than the current one and the blocks are regular (never for tiles). The registration
+ * functions call it, so a profile loaded from CSPARALLEL_TUNE_PROFILE applies without code changes; the block number never
+ * grows and a custom shape is never replaced.
+ * @param idf Index of the function.
+ * @return true if an entry was applied.
+ */
+bool applyTuningProfile(size_t idf);
+
+}
+
+#endif // CSTUNER_H_INCLUDED
@@ -0,0 +1,76 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include "csParallel.h"
+#include "csPerfChecker.h"
+
+// A loop whose cost per element grows with the index (element i costs about i inner iterations), as in a triangular
+// matrix or a simulation whose active region is at one end. Three shapes run the same steps:
+// - regular  : makeRegularBufferShape, equal element counts; the last block does most of the work;
+// - cost     : makeCostBufferShape with the known cost function;
+// - adaptive : regular shape at the first step, reshaped after each step from the measured block times (setAdaptiveShape).
+
+#define STEPS  8
+
+void triangularKernel(CSPARGS args)
+{
+    double* out = args.getArgPtr<double>(0);
+    CSPARGS::BOUNDS b = args.getBounds();
+    for (size_t i = b.first; i < b.last; i++)
+    {
+        double s = 0.0;
+        for (size_t k = 0; k < i; k++)
+            s += std::sqrt((double)k);
+        out[i] = s;
+    }
+}
+
+static double imbalance(const std::vector<double>& times)
+{
+    double total = 0.0, slowest = 0.0;
+    for (double t : times) { total += t; slowest = std::max(slowest, t); }
+    return total > 0.0 ? slowest * times.size() / total : 0.0;
+}
+
+static void runSteps(const char* name, size_t id, bool adaptive)
+{
+    // Une tolerance enorme mesure les temps par bloc sans jamais redecouper
+    csParallelTask::setAdaptiveShape(id, true, adaptive ? CSADAPTIVE_TOLERANCE : 1e300);
+    std::cout << std::left << std::setw(10) << name << std::right;
+    for (size_t s = 0; s < STEPS; s++)
+    {
+        CSPERF_CHECKER perf(CSTIME_UNIT_MICROSECOND);
+        perf.start();
+        csParallelTask::execute(id);
+        perf.stop();
+        std::cout << std::setw(8) << perf.getEllapsedTime() / 1000.0;
+        if (s == STEPS - 1)
+            std::cout << "   imbalance " << std::fixed << std::setprecision(2) << imbalance(csParallelTask::getBlockTimes(id));
+    }
+    std::cout << std::endl;
+}
+
+int main()
+{
+    const size_t N = 15000;
+    size_t nBlocks = csParallelTask::getAvailableConcurrency();
+    std::vector<double> out(N);
+
+    std::cout << N << " elements, " << nBlocks << " blocks, time per step in ms" << std::endl;
+
+    size_t idRegular = csParallelTask::registerFunctionRegularEx(nBlocks, N, "regular", triangularKernel, out.data());
+    runSteps("regular", idRegular, false);
+
+    BUFFER_SHAPE shape = csParallelTask::makeCostBufferShape(N, nBlocks, [](size_t i) { return (double)i + 1.0; });
+    size_t idCost = csParallelTask::registerFunctionEx(nBlocks, N, shape, "cost", triangularKernel, 1, out.data());
+    free(shape);
+    runSteps("cost", idCost, false);
+
+    size_t idAdaptive = csParallelTask::registerFunctionRegularEx(nBlocks, N, "adaptive", triangularKernel, out.data());
+    runSteps("adaptive", idAdaptive, true);
+
+    csParallelTask::unregisterAll();
+    return 0;
+}
@@ -0,0 +1,148 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cmath>
+#include "csParallel.h"
+#include "csPerfChecker.h"
+#include "csReduction.h"
+#include "csAlgorithm.h"
+
+// Compares the hand-written kernels of src/main.cpp (registered function + CSREDUCTION) with the header-level algorithms
+// (parallel_reduce / parallel_transform) on sum, dot, axpy and norm. For each operation:
+// - "kernel"   : execute() of a function registered once, as in main.cpp;
+// - "one-off"  : register + execute + unregister, the cost of a kernel written for a single loop;
+// - "algorithm": the equivalent csAlgorithm.h call, which does not touch the registry.
+
+static void kernel_sum(CSPARGS args)
+{
+    double* data = args.getArgPtr<double>(0);
+    CSREDUCTION<double>* partial = args.getArgPtr<CSREDUCTION<double>>(1);
+    CSPARGS::BOUNDS b = args.getBounds();
+    double sum = 0.0;
+    for (size_t i = b.first; i < b.last; i++) sum += data[i];
+    partial->accumulate(args.getBlockId(), sum);
+}
+
+static void kernel_dot(CSPARGS args)
+{
+    double* a = args.getArgPtr<double>(0);
+    double* b = args.getArgPtr<double>(1);
+    CSREDUCTION<double>* partial = args.getArgPtr<CSREDUCTION<double>>(2);
+    CSPARGS::BOUNDS r = args.getBounds();
+    double sum = 0.0;
+    for (size_t i = r.first; i < r.last; i++) sum += a[i] * b[i];
+    partial->accumulate(args.getBlockId(), sum);
+}
+
+static void kernel_sqsum(CSPARGS args)
+{
+    double* data = args.getArgPtr<double>(0);
+    CSREDUCTION<double>* partial = args.getArgPtr<CSREDUCTION<double>>(1);
+    CSPARGS::BOUNDS b = args.getBounds();
+    double sum = 0.0;
+    for (size_t i = b.first; i < b.last; i++) { double x = data[i]; sum += x * x; }
+    partial->accumulate(args.getBlockId(), sum);
+}
+
+static void kernel_axpy(CSPARGS args)
+{
+    double* x = args.getArgPtr<double>(0);
+    double* y = args.getArgPtr<double>(1);
+    double a = *args.getArgPtr<double>(2);
+    CSPARGS::BOUNDS b = args.getBounds();
+    for (size_t i = b.first; i < b.last; i++) y[i] = a * x[i] + y[i];
+}
+
+template<class F> static double usPerCall(size_t nCalls, F f)
+{
+    f();
+    CSPERF_CHECKER perf(CSTIME_UNIT_NANOSECOND);
+    perf.start();
+    for (size_t i = 0; i < nCalls; i++)
+        f();
+    perf.stop();
+    return (double)perf.getEllapsedTime() / nCalls / 1000.0;
+}
+
+static void printRow(const char* name, double kernelUs, double oneOffUs, double algoUs, double kernelRes, double algoRes)
+{
+    std::cout << std::left << std::setw(6) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(12) << kernelUs << std::setw(12) << oneOffUs << std::setw(12) << algoUs
+              << "   same result: " << (std::fabs(kernelRes - algoRes) <= 1e-9 * std::fabs(kernelRes) ? "yes" : "no") << std::endl;
+}
+
+int main()
+{
+    const size_t N = 10000000;
+    const size_t nCalls = 50;
+    size_t nThreads = csParallelTask::getHardwareConcurrency();
+    std::vector<double> x(N), y(N), y1(N, 1.0), y2(N, 1.0);
+    for (size_t i = 0; i < N; i++)
+    {
+        x[i] = std::sin(0.001 * i);
+        y[i] = std::cos(0.001 * i);
+    }
+    double alpha = 0.5;
+    const double* xs = x.data();
+    const double* ys = y.data();
+    auto sum = [](double a, double b) { return a + b; };
+
+    CSREDUCTION<double> red;
+    size_t idSum = csParallelTask::registerFunctionRegularEx(nThreads, N, "sum", kernel_sum, x.data(), &red);
+    size_t idDot = csParallelTask::registerFunctionRegularEx(nThreads, N, "dot", kernel_dot, x.data(), y.data(), &red);
+    size_t idNorm = csParallelTask::registerFunctionRegularEx(nThreads, N, "norm", kernel_sqsum, x.data(), &red);
+    size_t idAxpy = csParallelTask::registerFunctionRegularEx(nThreads, N, "axpy", kernel_axpy, x.data(), y1.data(), &alpha);
+
+    auto runReduction = [&](size_t id)
+    {
+        red.init(csParallelTask::getBlockNumber(id), 0.0, csReduceSum<double>);
+        csParallelTask::execute(id);
+        return red.combine();
+    };
+    auto runOneOff = [&](const char* name, void(*kernel)(CSPARGS), void* a, void* b)
+    {
+        size_t id = b ? csParallelTask::registerFunctionRegularEx(nThreads, N, name, kernel, a, b, &red)
+                      : csParallelTask::registerFunctionRegularEx(nThreads, N, name, kernel, a, &red);
+        double r = runReduction(id);
+        csParallelTask::unregisterFunction(id);
+        return r;
+    };
+
+    double sumK = 0, sumA = 0, dotK = 0, dotA = 0, normK = 0, normA = 0;
+    double sumKus = usPerCall(nCalls, [&] { sumK = runReduction(idSum); });
+    double sumOus = usPerCall(nCalls, [&] { runOneOff("sum1", kernel_sum, x.data(), 0); });
+    double sumAus = usPerCall(nCalls, [&] { sumA = csParallelTask::parallel_reduce((size_t)0, N, 0.0, [xs](size_t i) { return xs[i]; }, sum); });
+
+    double dotKus = usPerCall(nCalls, [&] { dotK = runReduction(idDot); });
+    double dotOus = usPerCall(nCalls, [&] { runOneOff("dot1", kernel_dot, x.data(), y.data()); });
+    double dotAus = usPerCall(nCalls, [&] { dotA = csParallelTask::parallel_reduce((size_t)0, N, 0.0, [xs, ys](size_t i) { return xs[i] * ys[i]; }, sum); });
+
+    double normKus = usPerCall(nCalls, [&] { normK = std::sqrt(runReduction(idNorm)); });
+    double normOus = usPerCall(nCalls, [&] { runOneOff("norm1", kernel_sqsum, x.data(), 0); });
+    double normAus = usPerCall(nCalls, [&] { normA = std::sqrt(csParallelTask::parallel_reduce((size_t)0, N, 0.0, [xs](size_t i) { return xs[i] * xs[i]; }, sum)); });
+
+    double axpyKus = usPerCall(nCalls, [&] { csParallelTask::execute(idAxpy); });
+    double axpyOus = usPerCall(nCalls, [&]
+    {
+        size_t id = csParallelTask::registerFunctionRegularEx(nThreads, N, "axpy1", kernel_axpy, x.data(), y1.data(), &alpha);
+        csParallelTask::execute(id);
+        csParallelTask::unregisterFunction(id);
+    });
+    double axpyAus = usPerCall(nCalls, [&]
+    {
+        csParallelTask::parallel_transform(x.begin(), x.end(), y2.begin(), y2.begin(), [alpha](double a, double b) { return alpha * a + b; });
+    });
+    // y1 a recu 2*nCalls+2 AXPY, y2 nCalls+1 : on compare une valeur recalculee
+    double axpyRefK = 1.0 + (2*nCalls + 2) * alpha * x[N-1];
+    double axpyRefA = 1.0 + (nCalls + 1) * alpha * x[N-1];
+
+    std::cout << "N = " << N << ", " << csParallelTask::getBlockNumber(idSum) << " blocks, time per call in us" << std::endl;
+    std::cout << std::left << std::setw(6) << "" << std::right << std::setw(12) << "kernel" << std::setw(12) << "one-off" << std::setw(12) << "algorithm" << std::endl;
+    printRow("sum", sumKus, sumOus, sumAus, sumK, sumA);
+    printRow("dot", dotKus, dotOus, dotAus, dotK, dotA);
+    printRow("norm", normKus, normOus, normAus, normK, normA);
+    printRow("axpy", axpyKus, axpyOus, axpyAus, y1[N-1] - axpyRefK + 1.0, y2[N-1] - axpyRefA + 1.0);
+
+    csParallelTask::unregisterAll();
+    return 0;
+}
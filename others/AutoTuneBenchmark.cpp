@@ -0,0 +1,83 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cmath>
+#include "csParallel.h"
+#include "csTuner.h"
+#include "csPerfChecker.h"
+
+// Hand-picked configuration (8 static blocks, as in src/main.cpp) against the configuration found by tuneFunction(),
+// for a memory-bound and a compute-bound kernel at three sizes. The profile is written to the file given on the command line
+// (csparallel.tune by default); in later runs started with CSPARALLEL_TUNE_PROFILE=<file>, registration applies it.
+
+static const char* scheduleName(int schedule)
+{
+    static const char* names[] = {"static", "stealing", "dynamic", "guided"};
+    return names[schedule];
+}
+
+void scaleKernel(CSPARGS args)
+{
+    const double* x = args.getArgPtr<double>(0);
+    double* y = args.getArgPtr<double>(1);
+    CSPARGS::BOUNDS b = args.getBounds();
+    for (size_t i = b.first; i < b.last; i++)
+        y[i] = 2.5 * x[i];
+}
+
+void heavyKernel(CSPARGS args)
+{
+    const double* x = args.getArgPtr<double>(0);
+    double* y = args.getArgPtr<double>(1);
+    CSPARGS::BOUNDS b = args.getBounds();
+    for (size_t i = b.first; i < b.last; i++)
+        y[i] = std::sin(x[i]) * std::exp(-x[i] * 1e-7) + std::sqrt(x[i]);
+}
+
+static double bestTime(size_t id)
+{
+    double best = 0.0;
+    for (int r = 0; r < 5; r++)
+    {
+        CSPERF_CHECKER perf(CSTIME_UNIT_NANOSECOND);
+        perf.start();
+        csParallelTask::execute(id);
+        perf.stop();
+        double t = perf.getEllapsedTime() / 1000.0;
+        best = r == 0 ? t : std::min(best, t);
+    }
+    return best;
+}
+
+int main(int argc, char** argv)
+{
+    const char* profile = argc > 1 ? argv[1] : "csparallel.tune";
+    const size_t maxN = (size_t)1 << 24;
+    std::vector<double> x(maxN), y(maxN);
+    for (size_t i = 0; i < maxN; i++)
+        x[i] = (double)i;
+
+    struct { const char* name; void (*func)(CSPARGS); } kernels[] = {{"scale", scaleKernel}, {"heavy", heavyKernel}};
+    std::cout << std::left << std::setw(8) << "kernel" << std::right << std::setw(10) << "N" << std::setw(14) << "manual us"
+              << std::setw(14) << "tuned us" << "   configuration" << std::endl;
+    for (auto& k : kernels)
+    {
+        for (size_t n : {(size_t)1 << 12, (size_t)1 << 18, maxN})
+        {
+            size_t id = csParallelTask::registerFunctionRegularEx(8, n, k.name, k.func, x.data(), y.data());
+            double manual = bestTime(id);
+            CSTUNE_ENTRY e = csParallelTask::tuneFunction(id);
+            double tuned = bestTime(id);
+            std::cout << std::left << std::setw(8) << k.name << std::right << std::setw(10) << n << std::fixed << std::setprecision(1)
+                      << std::setw(14) << manual << std::setw(14) << tuned << "   " << e.nBlocks << " blocks, " << scheduleName(e.schedule);
+            if (e.schedule != CSSCHEDULE_STATIC)
+                std::cout << ", chunk " << (e.chunkSize ? e.chunkSize : n / (e.nBlocks * 16));
+            std::cout << std::endl;
+            csParallelTask::unregisterFunction(id);
+        }
+    }
+
+    if (csParallelTask::saveTuningProfile(profile))
+        std::cout << "profile written to " << profile << std::endl;
+    return 0;
+}
@@ -0,0 +1,124 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <cmath>
+#include "csParallel.h"
+#include "csPerfChecker.h"
+#include "csGemm.h"
+
+// GFLOP/s of C = A * B for square matrices of growing size:
+// - "naive"  : the i-j-k kernel of MatrixMult2.cpp, one row band per thread;
+// - "scalar" : gemm() with the portable micro-kernel;
+// - "avx2"   : gemm() with the AVX2/FMA micro-kernel (when the CPU supports it).
+// The naive kernel is skipped above NAIVE_MAX_SIZE, where it takes seconds per run.
+
+#define NAIVE_MAX_SIZE  1024
+
+struct Matrix
+{
+    std::vector<double> data;
+    size_t rows;
+    size_t cols;
+
+    Matrix(size_t r, size_t c) : data(r * c, 0.0), rows(r), cols(c) {}
+
+    double& at(size_t i, size_t j) { return data[i * cols + j]; }
+    double at(size_t i, size_t j) const { return data[i * cols + j]; }
+};
+
+void multiplyMatricesParallel(CSPARGS args)
+{
+    Matrix* A = args.getArgPtr<Matrix>(0);
+    Matrix* B = args.getArgPtr<Matrix>(1);
+    Matrix* C = args.getArgPtr<Matrix>(2);
+    CSPARGS::BOUNDS bounds = args.getBounds();
+    size_t Bcols = B->cols, Acols = A->cols;
+
+    for (size_t i = bounds.first; i < bounds.last; i++)
+    {
+        for (size_t j = 0; j < Bcols; j++)
+        {
+            double sum = 0.0;
+            for (size_t k = 0; k < Acols; k++)
+                sum += A->at(i, k) * B->at(k, j);
+            C->at(i, j) = sum;
+        }
+    }
+}
+
+// Meilleur temps sur quelques executions, en GFLOP/s
+template<class F> static double gflops(size_t N, F f)
+{
+    double flops = 2.0 * N * N * N;
+    size_t nRuns = std::max((size_t)1, std::min((size_t)10, (size_t)(2e9 / flops)));
+    double best = 1e300;
+    f();
+    for (size_t r = 0; r < nRuns; r++)
+    {
+        CSPERF_CHECKER perf(CSTIME_UNIT_NANOSECOND);
+        perf.start();
+        f();
+        perf.stop();
+        best = std::min(best, (double)perf.getEllapsedTime());
+    }
+    return flops / best;
+}
+
+static double maxDiff(const Matrix& X, const Matrix& Y)
+{
+    double d = 0.0;
+    for (size_t i = 0; i < X.data.size(); i++)
+        d = std::max(d, std::fabs(X.data[i] - Y.data[i]));
+    return d;
+}
+
+int main()
+{
+    const size_t sizes[] = {64, 128, 256, 384, 512, 768, 1024, 1536, 2048};
+    size_t nThreads = csParallelTask::getAvailableConcurrency();
+    bool hasAvx2 = csParallelTask::setGemmKernel(CSGEMM_KERNEL_AVX2);
+
+    std::cout << nThreads << " threads, GFLOP/s (best run)" << std::endl;
+    std::cout << std::setw(6) << "N" << std::setw(10) << "naive" << std::setw(10) << "scalar" << std::setw(10) << "avx2"
+              << std::setw(14) << "max diff" << std::endl;
+
+    for (size_t N : sizes)
+    {
+        Matrix A(N, N), B(N, N), Cn(N, N), Cs(N, N), Cv(N, N);
+        std::mt19937 gen(1);
+        std::uniform_real_distribution<double> dis(0.0, 1.0);
+        for (double& v : A.data) v = dis(gen);
+        for (double& v : B.data) v = dis(gen);
+
+        std::cout << std::setw(6) << N << std::fixed << std::setprecision(2);
+        if (N <= NAIVE_MAX_SIZE)
+        {
+            size_t id = csParallelTask::registerFunctionRegularEx(nThreads, N, "naive", multiplyMatricesParallel, &A, &B, &Cn);
+            std::cout << std::setw(10) << gflops(N, [&] { csParallelTask::execute(id); });
+            csParallelTask::unregisterFunction(id);
+        }
+        else
+            std::cout << std::setw(10) << "-";
+
+        csParallelTask::setGemmKernel(CSGEMM_KERNEL_SCALAR);
+        std::cout << std::setw(10) << gflops(N, [&] { csParallelTask::matrixMultiply(N, N, N, A.data.data(), B.data.data(), Cs.data.data()); });
+        if (hasAvx2)
+        {
+            csParallelTask::setGemmKernel(CSGEMM_KERNEL_AVX2);
+            std::cout << std::setw(10) << gflops(N, [&] { csParallelTask::matrixMultiply(N, N, N, A.data.data(), B.data.data(), Cv.data.data()); });
+        }
+        else
+        {
+            Cv = Cs;
+            std::cout << std::setw(10) << "-";
+        }
+
+        double diff = maxDiff(Cs, Cv);
+        if (N <= NAIVE_MAX_SIZE)
+            diff = std::max(diff, maxDiff(Cn, Cs));
+        std::cout << std::scientific << std::setprecision(1) << std::setw(14) << diff << std::endl;
+    }
+    csParallelTask::setGemmKernel(CSGEMM_KERNEL_AUTO);
+    return 0;
+}
@@ -0,0 +1,65 @@
+#include <iostream>
+#include <vector>
+#include <memory>
+#include "csParallel.h"
+#include "csPerfChecker.h"
+
+// Compares a bandwidth-bound AXPY with and without NUMA placement:
+// 1. default: buffers initialised by the main thread, blocks run by any worker;
+// 2. NUMA: buffers initialised with firstTouch() and block i always run on the node that owns its pages.
+// The difference is only visible on multi-socket machines with buffers larger than the caches.
+
+static double msPerCall(size_t id, size_t nCalls)
+{
+    csParallelTask::execute(id);
+
+    CSPERF_CHECKER perf(CSTIME_UNIT_MICROSECOND);
+    perf.start();
+    for (size_t i = 0; i < nCalls; i++)
+        csParallelTask::execute(id);
+    perf.stop();
+    return (double)perf.getEllapsedTime() / nCalls / 1000.0;
+}
+
+int main()
+{
+    const size_t N = 1 << 25;
+    const size_t nCalls = 20;
+    size_t nThreads = csParallelTask::getHardwareConcurrency();
+    double alpha = 0.5;
+
+    // Memoire non initialisee : la premiere ecriture decide du noeud de chaque page
+    std::unique_ptr<double[]> x1(new double[N]), y1(new double[N]);
+    std::unique_ptr<double[]> x2(new double[N]), y2(new double[N]);
+
+    auto axpy = [alpha](CSPARGS& args, const double* x, double* y)
+    {
+        CSPARGS::BOUNDS b = args.getBounds();
+        for (size_t i = b.first; i < b.last; i++)
+            y[i] = alpha * x[i] + y[i];
+    };
+
+    size_t idDefault = csParallelTask::registerTaskRegular(nThreads, N, "axpy_default", axpy, (const double*)x1.get(), y1.get());
+    for (size_t i = 0; i < N; i++)
+    {
+        x1[i] = 1.0;
+        y1[i] = 0.0;
+    }
+
+    size_t idNuma = csParallelTask::registerTaskRegular(nThreads, N, "axpy_numa", axpy, (const double*)x2.get(), y2.get());
+    csParallelTask::setAffinityMode(idNuma, CSAFFINITY_NUMA);
+    csParallelTask::firstTouch(idNuma, x2.get(), 1.0);
+    csParallelTask::firstTouch(idNuma, y2.get(), 0.0);
+
+    double defaultMs = msPerCall(idDefault, nCalls);
+    double numaMs = msPerCall(idNuma, nCalls);
+    double bytes = 3.0 * N * sizeof(double);
+
+    std::cout << "NUMA nodes / blocks          : " << csParallelTask::getNumaNodeNumber() << " / " << csParallelTask::getBlockNumber(idNuma) << std::endl;
+    std::cout << "AXPY, default placement      : " << defaultMs << " ms (" << bytes / defaultMs * 1e-6 << " GB/s)" << std::endl;
+    std::cout << "AXPY, NUMA placement + touch : " << numaMs << " ms (" << bytes / numaMs * 1e-6 << " GB/s)" << std::endl;
+    std::cout << "Same result                  : " << (y1[N-1] == y2[N-1] ? "yes" : "no") << std::endl;
+
+    csParallelTask::unregisterAll();
+    return 0;
+}
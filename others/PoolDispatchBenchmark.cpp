@@ -0,0 +1,75 @@
+#include <iostream>
+#include <vector>
+#include <thread>
+#include "csParallel.h"
+#include "csPerfChecker.h"
+
+// Compares the per-call dispatch latency of csParallelTask::execute (persistent worker pool)
+// with the former spawn-per-call path (one std::thread created and joined per block).
+
+// Near-empty kernel: the measured time is dominated by dispatch
+void touchKernel(CSPARGS args)
+{
+    size_t* slots = args.getArgPtr<size_t>(0);
+    slots[args.getBlockId() * 8]++;
+}
+
+// Reproduces the former implementation of execute(): one thread per block, created then joined
+void executeSpawnPerCall(size_t id)
+{
+    std::vector<CSPARGS> blocks = csParallelTask::getArgs(id);
+    size_t nBlocks = blocks.size();
+    std::vector<std::thread> threads;
+
+    for (size_t i = 0; i < nBlocks; i++)
+    {
+        threads.push_back(std::thread(touchKernel, blocks[i]));
+    }
+    for (size_t i = 0; i < nBlocks; i++)
+    {
+        threads[i].join();
+    }
+}
+
+int main()
+{
+    const size_t nCalls = 20000;
+    size_t nThreads = csParallelTask::getHardwareConcurrency();
+
+    std::vector<size_t> slots(nThreads * 8, 0);
+
+    size_t id = csParallelTask::registerFunctionRegularEx(nThreads, nThreads, "touch", touchKernel, slots.data());
+
+    // Warm-up: creates the pool and wakes all workers once
+    for (size_t i = 0; i < 100; i++)
+    {
+        csParallelTask::execute(id);
+    }
+
+    CSPERF_CHECKER perf(CSTIME_UNIT_NANOSECOND);
+
+    perf.start();
+    for (size_t i = 0; i < nCalls; i++)
+    {
+        executeSpawnPerCall(id);
+    }
+    perf.stop();
+    double spawnNs = (double)perf.getEllapsedTime() / nCalls;
+
+    perf.start();
+    for (size_t i = 0; i < nCalls; i++)
+    {
+        csParallelTask::execute(id);
+    }
+    perf.stop();
+    double poolNs = (double)perf.getEllapsedTime() / nCalls;
+
+    std::cout << "Blocks per call          : " << csParallelTask::getArgs(id).size() << std::endl;
+    std::cout << "Calls                    : " << nCalls << std::endl;
+    std::cout << "Spawn per call (ns/call) : " << spawnNs << std::endl;
+    std::cout << "Worker pool    (ns/call) : " << poolNs << std::endl;
+    std::cout << "Dispatch speedup         : " << spawnNs / poolNs << "x" << std::endl;
+
+    csParallelTask::unregisterAll();
+    return 0;
+}
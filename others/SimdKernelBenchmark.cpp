@@ -0,0 +1,105 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cmath>
+#include "csParallel.h"
+#include "csPerfChecker.h"
+#include "csAlgorithm.h"
+#include "csSimd.h"
+
+// Memory throughput (GB/s) of the simd* kernels on double arrays, for every instruction set the CPU supports,
+// compared with the plain loops of src/main.cpp. Two sizes: a cache-resident array and a DRAM-sized one.
+// The last section runs simdSum per block through parallel_reduce, to approach the bandwidth of the whole machine.
+
+static double plainSum(const double* x, size_t n) { double s = 0.0; for (size_t i = 0; i < n; i++) s += x[i]; return s; }
+static double plainDot(const double* x, const double* y, size_t n) { double s = 0.0; for (size_t i = 0; i < n; i++) s += x[i] * y[i]; return s; }
+static double plainMin(const double* x, size_t n) { double m = x[0]; for (size_t i = 1; i < n; i++) if (x[i] < m) m = x[i]; return m; }
+static void plainAxpy(double a, const double* x, double* y, size_t n) { for (size_t i = 0; i < n; i++) y[i] = a * x[i] + y[i]; }
+static void plainScale(double* x, size_t n, double a) { for (size_t i = 0; i < n; i++) x[i] *= a; }
+static void plainFill(double* x, size_t n, double v) { for (size_t i = 0; i < n; i++) x[i] = v; }
+
+static volatile double sink;
+
+// Debit en Go/s du meilleur de nRuns appels traitant 'bytes' octets
+template<class F> static double gbps(size_t bytes, size_t nRuns, F f)
+{
+    double best = 1e300;
+    f();
+    for (size_t r = 0; r < nRuns; r++)
+    {
+        CSPERF_CHECKER perf(CSTIME_UNIT_NANOSECOND);
+        perf.start();
+        f();
+        perf.stop();
+        best = std::min(best, (double)std::max((size_t)1, perf.getEllapsedTime()));
+    }
+    return bytes / best;
+}
+
+static void runSize(size_t n, size_t nRuns)
+{
+    std::vector<double> x(n), y(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        x[i] = std::sin(0.001 * i);
+        y[i] = std::cos(0.001 * i);
+    }
+    const double* xs = x.data();
+    double* ys = y.data();
+    size_t B = n * sizeof(double);
+
+    std::cout << "n = " << n << " (" << B / 1024 << " KiB per array), GB/s" << std::endl;
+    std::cout << std::left << std::setw(8) << "" << std::right;
+    const char* names[] = {"sum", "kahan", "sqsum", "dot", "min", "argmin", "axpy", "scale", "fill"};
+    for (const char* name : names)
+        std::cout << std::setw(9) << name;
+    std::cout << std::endl << std::fixed << std::setprecision(1);
+
+    std::cout << std::left << std::setw(8) << "loop" << std::right
+              << std::setw(9) << gbps(B, nRuns, [&] { sink = plainSum(xs, n); })
+              << std::setw(9) << "-"
+              << std::setw(9) << gbps(B, nRuns, [&] { sink = plainDot(xs, xs, n); })
+              << std::setw(9) << gbps(2 * B, nRuns, [&] { sink = plainDot(xs, ys, n); })
+              << std::setw(9) << gbps(B, nRuns, [&] { sink = plainMin(xs, n); })
+              << std::setw(9) << "-"
+              << std::setw(9) << gbps(3 * B, nRuns, [&] { plainAxpy(1e-9, xs, ys, n); })
+              << std::setw(9) << gbps(2 * B, nRuns, [&] { plainScale(ys, n, 1.0000001); })
+              << std::setw(9) << gbps(B, nRuns, [&] { plainFill(ys, n, 0.5); }) << std::endl;
+
+    for (int level = CSSIMD_SCALAR; level <= csParallelTask::getCpuSimdLevel(); level++)
+    {
+        csParallelTask::setSimdLevel(level);
+        std::cout << std::left << std::setw(8) << csParallelTask::getSimdLevelName(level) << std::right
+                  << std::setw(9) << gbps(B, nRuns, [&] { sink = csParallelTask::simdSum(xs, n); })
+                  << std::setw(9) << gbps(B, nRuns, [&] { sink = csParallelTask::simdKahanSum(xs, n); })
+                  << std::setw(9) << gbps(B, nRuns, [&] { sink = csParallelTask::simdSumSquares(xs, n); })
+                  << std::setw(9) << gbps(2 * B, nRuns, [&] { sink = csParallelTask::simdDot(xs, ys, n); })
+                  << std::setw(9) << gbps(B, nRuns, [&] { sink = csParallelTask::simdMin(xs, n); })
+                  << std::setw(9) << gbps(B, nRuns, [&] { sink = (double)csParallelTask::simdArgMin(xs, n); })
+                  << std::setw(9) << gbps(3 * B, nRuns, [&] { csParallelTask::simdAxpy(1e-9, xs, ys, n); })
+                  << std::setw(9) << gbps(2 * B, nRuns, [&] { csParallelTask::simdScale(ys, n, 1.0000001); })
+                  << std::setw(9) << gbps(B, nRuns, [&] { csParallelTask::simdFill(ys, n, 0.5); }) << std::endl;
+    }
+    csParallelTask::setSimdLevel(csParallelTask::getCpuSimdLevel());
+
+    // Somme sur tous les threads : un appel simdSum par morceau de CSALGORITHM_GRAIN*16 elements
+    const size_t chunk = CSALGORITHM_GRAIN * 16;
+    size_t nChunks = (n + chunk - 1) / chunk;
+    double parallel = gbps(B, nRuns, [&]
+    {
+        sink = csParallelTask::parallel_reduce((size_t)0, nChunks, 0.0, [&](size_t c)
+        {
+            size_t first = c * chunk;
+            return csParallelTask::simdSum(xs + first, std::min(chunk, n - first));
+        }, [](double a, double b) { return a + b; }, 1);
+    });
+    std::cout << "parallel simdSum (" << csParallelTask::getAvailableConcurrency() << " threads): " << parallel << " GB/s" << std::endl << std::endl;
+}
+
+int main()
+{
+    std::cout << "CPU SIMD level: " << csParallelTask::getSimdLevelName(csParallelTask::getCpuSimdLevel()) << std::endl << std::endl;
+    runSize(16 * 1024, 2000);
+    runSize(32 * 1024 * 1024, 10);
+    return 0;
+}
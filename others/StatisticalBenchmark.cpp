@@ -0,0 +1,55 @@
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include "csParallel.h"
+#include "csBenchmark.h"
+
+// Same kernel run sequentially, with 8 static blocks and with work stealing, measured with warm-up runs, 30 samples and the
+// MAD outlier filter instead of one CSPERF_CHECKER sample. A sub-microsecond kernel shows the batching of short runs.
+// The statistics are written to the JSON file given on the command line (benchmark.json by default) and to benchmark.csv.
+
+void heavyKernel(CSPARGS args)
+{
+    const double* x = args.getArgPtr<double>(0);
+    double* y = args.getArgPtr<double>(1);
+    CSPARGS::BOUNDS b = args.getBounds();
+    for (size_t i = b.first; i < b.last; i++)
+        y[i] = std::sin(x[i]) * std::exp(-x[i] * 1e-7) + std::sqrt(x[i]);
+}
+
+int main(int argc, char** argv)
+{
+    const char* path = argc > 1 ? argv[1] : "benchmark.json";
+    const size_t N = (size_t)1 << 20;
+    std::vector<double> x(N), y(N);
+    for (size_t i = 0; i < N; i++)
+        x[i] = (double)i;
+
+    size_t id = csParallelTask::registerFunctionRegularEx(8, N, "heavy", heavyKernel, x.data(), y.data());
+
+    CSBENCHMARK bench(30, 3);
+    bench.setTimeUnit(CSTIME_UNIT_MICROSECOND);
+    bench.run("sequential", [&]() {
+        for (size_t i = 0; i < N; i++)
+            y[i] = std::sin(x[i]) * std::exp(-x[i] * 1e-7) + std::sqrt(x[i]);
+    });
+    bench.runFunction("8 static blocks", id);
+    csParallelTask::setSchedulingMode(id, CSSCHEDULE_WORK_STEALING, 4096);
+    bench.runFunction("work stealing", id);
+
+    // Quelques dizaines de nanosecondes : chaque echantillon est un lot d'executions
+    volatile double acc = 0.0;
+    CSBENCH_RESULT tiny = bench.run("64 sqrt", [&]() {
+        double s = 0.0;
+        for (int i = 0; i < 64; i++)
+            s += std::sqrt((double)i + acc);
+        acc = s * 1e-30;
+    });
+
+    bench.printReport();
+    std::cout << "\"64 sqrt\" : median " << tiny.median << " ns, batches of " << tiny.batch << " runs" << std::endl;
+    if (bench.writeJson(path) && bench.writeCsv("benchmark.csv"))
+        std::cout << "results written to " << path << " and benchmark.csv" << std::endl;
+    csParallelTask::unregisterAll();
+    return 0;
+}
@@ -0,0 +1,102 @@
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include "csParallel.h"
+#include "csTaskGraph.h"
+#include "csPerfChecker.h"
+
+// Pipeline fill -> scale -> axpy -> sum of squares, run once as four blocking execute() calls
+// and once as a task graph with block-to-block dependencies: block i of a stage starts as soon as
+// block i of the previous stage is done, on the same thread while its data is still in cache.
+
+void kernelFill(CSPARGS args)
+{
+    double* x = args.getArgPtr<double>(0);
+    double value = *args.getArgPtr<double>(1);
+    CSPARGS::BOUNDS b = args.getBounds();
+    for (size_t i = b.first; i < b.last; i++) x[i] = value + 1e-6 * i;
+}
+
+void kernelScale(CSPARGS args)
+{
+    double* x = args.getArgPtr<double>(0);
+    double factor = *args.getArgPtr<double>(1);
+    CSPARGS::BOUNDS b = args.getBounds();
+    for (size_t i = b.first; i < b.last; i++) x[i] *= factor;
+}
+
+void kernelAxpy(CSPARGS args)
+{
+    double* x = args.getArgPtr<double>(0);
+    double* y = args.getArgPtr<double>(1);
+    double alpha = *args.getArgPtr<double>(2);
+    CSPARGS::BOUNDS b = args.getBounds();
+    for (size_t i = b.first; i < b.last; i++) y[i] = alpha * x[i] + y[i];
+}
+
+// Each block writes its partial sum into its own slot (8 doubles apart to avoid false sharing)
+void kernelSqSum(CSPARGS args)
+{
+    double* y = args.getArgPtr<double>(0);
+    double* partial = args.getArgPtr<double>(1);
+    CSPARGS::BOUNDS b = args.getBounds();
+    double sum = 0.0;
+    for (size_t i = b.first; i < b.last; i++) sum += y[i] * y[i];
+    partial[args.getBlockId() * 8] = sum;
+}
+
+static double runPipeline(bool useGraph, size_t N, size_t nThreads, size_t& elapsed)
+{
+    std::vector<double> x(N), y(N, 1.0), partial(nThreads * 8, 0.0);
+    double value = 1.0, factor = 2.0, alpha = 0.5;
+
+    size_t idFill = csParallelTask::registerFunctionRegularEx(nThreads, N, "fill", kernelFill, x.data(), &value);
+    size_t idScale = csParallelTask::registerFunctionRegularEx(nThreads, N, "scale", kernelScale, x.data(), &factor);
+    size_t idAxpy = csParallelTask::registerFunctionRegularEx(nThreads, N, "axpy", kernelAxpy, x.data(), y.data(), &alpha);
+    size_t idNorm = csParallelTask::registerFunctionRegularEx(nThreads, N, "sqsum", kernelSqSum, y.data(), partial.data());
+
+    CSTASK_GRAPH graph;
+    graph.addDependency(idFill, idScale, CSDEPENDENCY_BLOCK);
+    graph.addDependency(idScale, idAxpy, CSDEPENDENCY_BLOCK);
+    graph.addDependency(idAxpy, idNorm, CSDEPENDENCY_BLOCK);
+
+    CSPERF_CHECKER perf(CSTIME_UNIT_MICROSECOND);
+    perf.start();
+    if (useGraph)
+    {
+        graph.execute();
+    }
+    else
+    {
+        csParallelTask::execute(idFill);
+        csParallelTask::execute(idScale);
+        csParallelTask::execute(idAxpy);
+        csParallelTask::execute(idNorm);
+    }
+    perf.stop();
+    elapsed = perf.getEllapsedTime();
+
+    double sum = 0.0;
+    for (size_t i = 0; i < csParallelTask::getBlockNumber(idNorm); i++) sum += partial[i * 8];
+
+    csParallelTask::unregisterAll();
+    return std::sqrt(sum);
+}
+
+int main()
+{
+    const size_t N = 10000000;
+    size_t nThreads = csParallelTask::getHardwareConcurrency();
+    size_t tBarrier, tGraph;
+
+    double normBarrier = runPipeline(false, N, nThreads, tBarrier);
+    double normGraph = runPipeline(true, N, nThreads, tGraph);
+
+    std::cout << "Blocks                      : " << nThreads << std::endl;
+    std::cout << "Blocking execute() (us)     : " << tBarrier << "  norm = " << normBarrier << std::endl;
+    std::cout << "Task graph         (us)     : " << tGraph << "  norm = " << normGraph << std::endl;
+    if (tGraph > 0)
+        std::cout << "Speedup                     : " << (double)tBarrier / tGraph << "x" << std::endl;
+
+    return 0;
+}
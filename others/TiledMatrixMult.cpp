@@ -0,0 +1,91 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cmath>
+#include "csParallel.h"
+#include "csPerfChecker.h"
+
+// C = A * B with the same kernel on three shapes of the output:
+// 1. row bands (one band per thread, as in MatrixMult2.cpp);
+// 2. square tiles in row-major order;
+// 3. square tiles in Morton order.
+// The kernel reads the rows and columns of its tile with CSPARGS::getTile().
+
+struct Matrix
+{
+    std::vector<double> data;
+    size_t rows;
+    size_t cols;
+
+    Matrix(size_t r, size_t c) : data(r * c, 0.0), rows(r), cols(c) {}
+
+    double& at(size_t i, size_t j) { return data[i * cols + j]; }
+    double at(size_t i, size_t j) const { return data[i * cols + j]; }
+};
+
+void multiplyTile(CSPARGS args)
+{
+    const Matrix* A = args.getArgPtr<Matrix>(0);
+    const Matrix* B = args.getArgPtr<Matrix>(1);
+    Matrix* C = args.getArgPtr<Matrix>(2);
+    CSPARGS::TILE t = args.getTile();
+    size_t K = A->cols;
+
+    // Ordre i-k-j : la ligne de B est parcourue de facon contigue
+    for (size_t i = t.y.first; i < t.y.last; i++)
+    {
+        for (size_t j = t.x.first; j < t.x.last; j++)
+            C->at(i, j) = 0.0;
+        for (size_t k = 0; k < K; k++)
+        {
+            double a = A->at(i, k);
+            const double* b = &B->data[k * B->cols];
+            double* c = &C->data[i * C->cols];
+            for (size_t j = t.x.first; j < t.x.last; j++)
+                c[j] += a * b[j];
+        }
+    }
+}
+
+static double runShape(const char* name, TILE_SHAPE shape, size_t nTiles, Matrix& A, Matrix& B, Matrix& C)
+{
+    size_t id = csParallelTask::registerFunctionTiledEx(shape, nTiles, name, multiplyTile, &A, &B, &C);
+    free(shape);
+    csParallelTask::execute(id);
+
+    CSPERF_CHECKER perf(CSTIME_UNIT_MICROSECOND);
+    perf.start();
+    csParallelTask::execute(id);
+    perf.stop();
+    csParallelTask::unregisterFunction(id);
+
+    double ms = perf.getEllapsedTime() / 1000.0;
+    std::cout << name << " (" << nTiles << " blocks) : " << ms << " ms" << std::endl;
+    return ms;
+}
+
+int main()
+{
+    const size_t N = 1024;
+    const size_t tile = 128;
+    size_t nThreads = csParallelTask::getAvailableConcurrency();
+    size_t nTiles;
+
+    Matrix A(N, N), B(N, N), C1(N, N), C2(N, N), C3(N, N);
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<double> dis(0.0, 1.0);
+    for (double& v : A.data) v = dis(gen);
+    for (double& v : B.data) v = dis(gen);
+
+    runShape("Row bands   ", csParallelTask::makeRowBandShape(N, N, nThreads), nThreads, A, B, C1);
+    TILE_SHAPE tiles = csParallelTask::makeTileShape(N, N, tile, tile, &nTiles);
+    runShape("Tiles       ", tiles, nTiles, A, B, C2);
+    TILE_SHAPE morton = csParallelTask::makeMortonTileShape(N, N, tile, tile, &nTiles);
+    runShape("Morton tiles", morton, nTiles, A, B, C3);
+
+    double maxDiff = 0.0;
+    for (size_t i = 0; i < N * N; i++)
+        maxDiff = std::max(maxDiff, std::max(std::fabs(C1.data[i] - C2.data[i]), std::fabs(C1.data[i] - C3.data[i])));
+    std::cout << "Maximum difference: " << maxDiff << std::endl;
+    return 0;
+}
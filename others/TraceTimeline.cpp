@@ -0,0 +1,79 @@
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include "csParallel.h"
+#include "csTaskGraph.h"
+#include "csTrace.h"
+
+// Three-stage pipeline traced into a Chrome trace-event file (trace.json by default): open it in https://ui.perfetto.dev
+// or chrome://tracing. The "smooth" stage is cut in regular blocks although its cost grows with the index, so its last block
+// is a visible straggler; the same stages run a second time as a task graph, then with work stealing, where the steals show
+// as instant events on the thief's track.
+
+void kernelInit(CSPARGS args)
+{
+    double* x = args.getArgPtr<double>(0);
+    CSPARGS::BOUNDS b = args.getBounds();
+    for (size_t i = b.first; i < b.last; i++) x[i] = std::sin(1e-3 * i);
+}
+
+void kernelSmooth(CSPARGS args)
+{
+    double* x = args.getArgPtr<double>(0);
+    double* y = args.getArgPtr<double>(1);
+    size_t n = args.getWorkSize();
+    CSPARGS::BOUNDS b = args.getBounds();
+    for (size_t i = b.first; i < b.last; i++)
+    {
+        // Fenetre proportionnelle a l'indice : les derniers blocs coutent le plus
+        size_t w = 1 + i / 512;
+        double s = 0.0;
+        for (size_t k = i; k < std::min(n, i + w); k++) s += x[k];
+        y[i] = s / w;
+    }
+}
+
+void kernelScale(CSPARGS args)
+{
+    double* y = args.getArgPtr<double>(0);
+    CSPARGS::BOUNDS b = args.getBounds();
+    for (size_t i = b.first; i < b.last; i++) y[i] *= 0.5;
+}
+
+int main(int argc, char** argv)
+{
+    const char* path = argc > 1 ? argv[1] : "trace.json";
+    const size_t N = 200000;
+    size_t nThreads = csParallelTask::getAvailableConcurrency();
+    std::vector<double> x(N), y(N);
+
+    size_t idInit = csParallelTask::registerFunctionRegularEx(nThreads, N, "init", kernelInit, x.data());
+    size_t idSmooth = csParallelTask::registerFunctionRegularEx(nThreads, N, "smooth", kernelSmooth, x.data(), y.data());
+    size_t idScale = csParallelTask::registerFunctionRegularEx(nThreads, N, "scale", kernelScale, y.data());
+
+    csParallelTask::setTracing(true);
+
+    csParallelTask::traceBegin("blocking executes");
+    csParallelTask::execute(idInit);
+    csParallelTask::execute("smooth");
+    csParallelTask::execute(kernelScale);
+    csParallelTask::traceEnd("blocking executes");
+
+    csParallelTask::traceBegin("task graph");
+    CSTASK_GRAPH graph;
+    graph.addDependency(idInit, idSmooth, CSDEPENDENCY_TASK);
+    graph.addDependency(idSmooth, idScale, CSDEPENDENCY_BLOCK);
+    graph.execute();
+    csParallelTask::traceEnd("task graph");
+
+    csParallelTask::traceBegin("work stealing");
+    csParallelTask::setSchedulingMode(idSmooth, CSSCHEDULE_WORK_STEALING, 1024);
+    csParallelTask::execute(idSmooth);
+    csParallelTask::traceEnd("work stealing");
+
+    csParallelTask::setTracing(false);
+    if (csParallelTask::dumpTrace(path))
+        std::cout << "trace written to " << path << std::endl;
+    csParallelTask::unregisterAll();
+    return 0;
+}
@@ -0,0 +1,80 @@
+#include <iostream>
+#include <vector>
+#include "csParallel.h"
+#include "csPerfChecker.h"
+
+// Compares the void*-based registration (registerFunctionRegularEx + getArgPtr) with the typed registration (registerTaskRegular):
+// 1. dispatch cost per execute() with a near-empty kernel;
+// 2. per-call cost with CSSCHEDULE_DYNAMIC and small chunks, where the kernel is entered once per chunk.
+
+void touchKernel(CSPARGS args)
+{
+    size_t* slots = args.getArgPtr<size_t>(0);
+    slots[args.getBlockId() * 8]++;
+}
+
+void axpyKernel(CSPARGS args)
+{
+    const double* x = args.getArgPtr<double>(0);
+    double* y = args.getArgPtr<double>(1);
+    double a = *args.getArgPtr<double>(2);
+    CSPARGS::BOUNDS b = args.getBounds();
+    for (size_t i = b.first; i < b.last; i++)
+        y[i] = a * x[i] + y[i];
+}
+
+static double nsPerCall(size_t id, size_t nCalls)
+{
+    for (size_t i = 0; i < 100; i++)
+        csParallelTask::execute(id);
+
+    CSPERF_CHECKER perf(CSTIME_UNIT_NANOSECOND);
+    perf.start();
+    for (size_t i = 0; i < nCalls; i++)
+        csParallelTask::execute(id);
+    perf.stop();
+    return (double)perf.getEllapsedTime() / nCalls;
+}
+
+int main()
+{
+    const size_t nCalls = 20000;
+    const size_t N = 1 << 20;
+    const size_t chunk = 256;
+    size_t nThreads = csParallelTask::getHardwareConcurrency();
+
+    std::vector<size_t> slots(nThreads * 8, 0);
+    std::vector<double> x(N, 1.0), y1(N, 0.0), y2(N, 0.0);
+    double alpha = 0.5;
+
+    size_t idTouch = csParallelTask::registerFunctionRegularEx(nThreads, nThreads, "touch", touchKernel, slots.data());
+    size_t idTouchTyped = csParallelTask::registerTaskRegular(nThreads, nThreads, "touch_typed",
+        [](CSPARGS& args, size_t* s) { s[args.getBlockId() * 8]++; }, slots.data());
+
+    size_t idAxpy = csParallelTask::registerFunctionRegularEx(nThreads, N, "axpy", axpyKernel, x.data(), y1.data(), &alpha);
+    // Capturing lambda: alpha is copied into the closure, x and y are typed arguments
+    size_t idAxpyTyped = csParallelTask::registerTaskRegular(nThreads, N, "axpy_typed",
+        [alpha](CSPARGS& args, const double* xs, double* ys)
+        {
+            CSPARGS::BOUNDS b = args.getBounds();
+            for (size_t i = b.first; i < b.last; i++)
+                ys[i] = alpha * xs[i] + ys[i];
+        }, (const double*)x.data(), y2.data());
+    csParallelTask::setSchedulingMode(idAxpy, CSSCHEDULE_DYNAMIC, chunk);
+    csParallelTask::setSchedulingMode(idAxpyTyped, CSSCHEDULE_DYNAMIC, chunk);
+
+    double touchNs = nsPerCall(idTouch, nCalls);
+    double touchTypedNs = nsPerCall(idTouchTyped, nCalls);
+    double axpyNs = nsPerCall(idAxpy, 200);
+    double axpyTypedNs = nsPerCall(idAxpyTyped, 200);
+
+    std::cout << "Blocks per call                        : " << csParallelTask::getBlockNumber(idTouch) << std::endl;
+    std::cout << "Empty kernel, registerFunctionRegularEx : " << touchNs << " ns/call" << std::endl;
+    std::cout << "Empty kernel, registerTaskRegular       : " << touchTypedNs << " ns/call" << std::endl;
+    std::cout << "AXPY chunk " << chunk << ", registerFunctionRegularEx : " << axpyNs << " ns/call" << std::endl;
+    std::cout << "AXPY chunk " << chunk << ", registerTaskRegular       : " << axpyTypedNs << " ns/call" << std::endl;
+    std::cout << "Same result                            : " << (y1 == y2 ? "yes" : "no") << std::endl;
+
+    csParallelTask::unregisterAll();
+    return 0;
+}
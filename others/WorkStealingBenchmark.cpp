@@ -0,0 +1,116 @@
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include "csParallel.h"
+#include "csPerfChecker.h"
+
+// Compares CSSCHEDULE_STATIC with CSSCHEDULE_WORK_STEALING, CSSCHEDULE_DYNAMIC and CSSCHEDULE_GUIDED on a deliberately imbalanced kernel:
+// a lower-triangular matrix-vector product, where row i costs i multiply-adds.
+// With a static split, the last block holds most of the work and the whole call waits for it.
+
+static double lowerValue(size_t i, size_t j)
+{
+    return 1.0 / (1.0 + i + j);
+}
+
+void triangularMatVec(CSPARGS args)
+{
+    const double* x = args.getArgPtr<double>(0);
+    double* y = args.getArgPtr<double>(1);
+    CSPARGS::BOUNDS b = args.getBounds();
+
+    for (size_t i = b.first; i < b.last; i++)
+    {
+        double sum = 0.0;
+        for (size_t j = 0; j <= i; j++)
+        {
+            sum += lowerValue(i, j) * x[j];
+        }
+        y[i] = sum;
+    }
+}
+
+// Same kernel written with CSPARGS::nextChunk(): called once per block, it iterates over the chunks it is handed
+void triangularMatVecChunks(CSPARGS args)
+{
+    const double* x = args.getArgPtr<double>(0);
+    double* y = args.getArgPtr<double>(1);
+    CSPARGS::BOUNDS b;
+
+    while (args.nextChunk(b))
+    {
+        for (size_t i = b.first; i < b.last; i++)
+        {
+            double sum = 0.0;
+            for (size_t j = 0; j <= i; j++)
+            {
+                sum += lowerValue(i, j) * x[j];
+            }
+            y[i] = sum;
+        }
+    }
+}
+
+static size_t timeCalls(size_t id, int repeat)
+{
+    CSPERF_CHECKER perf(CSTIME_UNIT_MICROSECOND);
+    csParallelTask::execute(id);
+    perf.start();
+    for (int r = 0; r < repeat; r++)
+        csParallelTask::execute(id);
+    perf.stop();
+    return perf.getEllapsedTime() / repeat;
+}
+
+static double maxDifference(const std::vector<double>& a, const std::vector<double>& b)
+{
+    double maxDiff = 0.0;
+    for (size_t i = 0; i < a.size(); i++)
+    {
+        maxDiff = std::max(maxDiff, std::abs(a[i] - b[i]));
+    }
+    return maxDiff;
+}
+
+int main()
+{
+    const size_t N = 12000;
+    const int repeat = 5;
+    size_t nThreads = csParallelTask::getHardwareConcurrency();
+
+    std::vector<double> x(N), yStatic(N, 0.0), ySteal(N, 0.0), yDynamic(N, 0.0), yGuided(N, 0.0);
+    for (size_t i = 0; i < N; i++)
+    {
+        x[i] = std::sin(0.01 * i);
+    }
+
+    size_t idStatic = csParallelTask::registerFunctionRegularEx(nThreads, N, "trmv_static", triangularMatVec,
+        x.data(), yStatic.data());
+    size_t idSteal = csParallelTask::registerFunctionRegularEx(nThreads, N, "trmv_steal", triangularMatVec,
+        x.data(), ySteal.data());
+    size_t idDynamic = csParallelTask::registerFunctionRegularEx(nThreads, N, "trmv_dynamic", triangularMatVecChunks,
+        x.data(), yDynamic.data());
+    size_t idGuided = csParallelTask::registerFunctionRegularEx(nThreads, N, "trmv_guided", triangularMatVecChunks,
+        x.data(), yGuided.data());
+    csParallelTask::setSchedulingMode(idSteal, CSSCHEDULE_WORK_STEALING, 16);
+    csParallelTask::setSchedulingMode(idDynamic, CSSCHEDULE_DYNAMIC, 16);
+    csParallelTask::setSchedulingMode(idGuided, CSSCHEDULE_GUIDED, 4);
+
+    size_t tStatic = timeCalls(idStatic, repeat);
+    size_t tSteal = timeCalls(idSteal, repeat);
+    size_t tDynamic = timeCalls(idDynamic, repeat);
+    size_t tGuided = timeCalls(idGuided, repeat);
+
+    std::cout << "Blocks                       : " << csParallelTask::getArgs(idSteal).size() << std::endl;
+    std::cout << "Static split   (us per call) : " << tStatic << std::endl;
+    std::cout << "Work stealing  (us per call) : " << tSteal << std::endl;
+    std::cout << "Dynamic        (us per call) : " << tDynamic << std::endl;
+    std::cout << "Guided         (us per call) : " << tGuided << std::endl;
+    if (tSteal > 0)
+        std::cout << "Stealing speedup             : " << (double)tStatic / tSteal << "x" << std::endl;
+    std::cout << "Maximum difference           : " << std::max(maxDifference(yStatic, ySteal),
+        std::max(maxDifference(yStatic, yDynamic), maxDifference(yStatic, yGuided))) << std::endl;
+
+    csParallelTask::unregisterAll();
+    return 0;
+}
@@ -1,12 +1,15 @@
 #!/usr/bin/env python3
 """
-Génère un diagramme en barres à partir de la sortie de csParallelTask_test.
+Génère un diagramme en barres à partir de la sortie de csParallelTask_test, ou les courbes de mise à l'échelle
+à partir du JSON de csParallelTask_benchmark.
 Usage:
   python plot_benchmark.py < sortie.txt
   python plot_benchmark.py sortie.txt
   csParallelTask_test.exe | python plot_benchmark.py
+  python plot_benchmark.py benchmark.json [dossier_de_sortie]
 """
 
+import json
 import re
 import sys
 import os
@@ -216,6 +219,145 @@ def plot_bars(n_threads, N, benchmarks, machine_info, out_path):
     print(f"Figure sauvegardée : {out_path}")
 
 
+def group_results(results, mode):
+    """Regroupe les mesures d'un mode par noyau puis par série, chaque série triée par nombre de threads."""
+    groups = {}
+    for r in results:
+        if r["mode"] != mode or r["median"] <= 0:
+            continue
+        key = r["size"] if mode == "strong" else r["perThread"]
+        groups.setdefault(r["kernel"], {}).setdefault(key, []).append(r)
+    for series in groups.values():
+        for points in series.values():
+            points.sort(key=lambda r: r["threads"])
+    return groups
+
+
+def format_bytes(n):
+    """Taille lisible : 16 KiB, 4 MiB..."""
+    for unit in ("B", "KiB", "MiB", "GiB"):
+        if n < 1024 or unit == "GiB":
+            return f"{n:g} {unit}"
+        n /= 1024
+
+
+def series_label(kernel, key, points, mode):
+    if mode == "weak":
+        return f"{format_bytes(key)} / thread"
+    if kernel == "gemm":
+        return f"{key} x {key}"
+    return format_bytes(points[0]["bytes"])
+
+
+def kernel_grid(n):
+    """Grille de sous-graphiques, un par noyau."""
+    cols = min(4, n)
+    rows = (n + cols - 1) // cols
+    fig, axes = plt.subplots(rows, cols, figsize=(4.2 * cols, 3.4 * rows), squeeze=False)
+    for ax in axes.flat[n:]:
+        ax.set_visible(False)
+    return fig, list(axes.flat)
+
+
+def json_title(fig, data, what):
+    m = data.get("machine", {})
+    fig.suptitle(
+        f"csParallelTask — {what}  |  {m.get('cpu', 'CPU')}  ({m.get('availableConcurrency', '?')} threads, "
+        f"{m.get('simd', '?')}, {m.get('compiler', '?')})",
+        fontsize=11,
+    )
+
+
+def save(fig, out_path):
+    fig.tight_layout()
+    fig.savefig(out_path, dpi=150, bbox_inches="tight")
+    plt.close(fig)
+    print(f"Figure sauvegardée : {out_path}")
+
+
+def plot_scaling(data, mode, efficiency, out_path):
+    """Mise à l'échelle forte (accélération T(1)/T(p) ou efficacité T(1)/(p T(p))) ou faible (efficacité T(1)/T(p))."""
+    groups = group_results(data["results"], mode)
+    if not groups:
+        print(f"Aucune mesure '{mode}'.")
+        return
+    threads = data["settings"]["threads"]
+    fig, axes = kernel_grid(len(groups))
+    for ax, (kernel, series) in zip(axes, groups.items()):
+        for key in sorted(series):
+            points = series[key]
+            base = next((r["median"] for r in points if r["threads"] == 1), None)
+            if base is None:
+                continue
+            p = [r["threads"] for r in points]
+            if mode == "weak":
+                y = [base / r["median"] for r in points]
+            elif efficiency:
+                y = [base / (r["median"] * r["threads"]) for r in points]
+            else:
+                y = [base / r["median"] for r in points]
+            ax.plot(p, y, marker="o", markersize=3, label=series_label(kernel, key, points, mode))
+        if mode == "strong" and not efficiency:
+            ax.plot(threads, threads, color="gray", linestyle="--", linewidth=1, label="idéal")
+        else:
+            ax.axhline(y=1, color="gray", linestyle="--", linewidth=1)
+            ax.set_ylim(0, 1.2)
+        ax.set_xscale("log", base=2)
+        ax.set_xticks(threads)
+        ax.set_xticklabels([str(t) for t in threads])
+        ax.set_title(kernel)
+        ax.set_xlabel("Threads")
+        ax.set_ylabel("Efficacité" if efficiency or mode == "weak" else "Accélération (x)")
+        ax.grid(linestyle="--", alpha=0.6)
+        ax.legend(fontsize=7)
+    what = {("strong", False): "mise à l'échelle forte", ("strong", True): "efficacité (forte)",
+            ("weak", True): "mise à l'échelle faible (efficacité)"}[(mode, efficiency)]
+    json_title(fig, data, what)
+    save(fig, out_path)
+
+
+def plot_throughput(data, out_path):
+    """Débit en fonction de la taille, séquentiel, 1 thread et tous les threads, avec les tailles des caches."""
+    results = data["results"]
+    kernels = []
+    for r in results:
+        if r["mode"] == "strong" and r["kernel"] not in kernels:
+            kernels.append(r["kernel"])
+    if not kernels:
+        return
+    max_threads = max(data["settings"]["threads"])
+    caches = [c for c in data.get("machine", {}).get("caches", []) if c.get("type") != "Instruction"]
+    fig, axes = kernel_grid(len(kernels))
+    for ax, kernel in zip(axes, kernels):
+        rows = [r for r in results if r["kernel"] == kernel and r["median"] > 0]
+        unit = "GFLOP/s" if rows and rows[0]["workUnit"] == "flops" else "GB/s"
+        for label, keep in (("séquentiel", lambda r: r["mode"] == "sequential"),
+                            ("1 thread", lambda r: r["mode"] == "strong" and r["threads"] == 1),
+                            (f"{max_threads} threads", lambda r: r["mode"] == "strong" and r["threads"] == max_threads)):
+            points = sorted((r for r in rows if keep(r)), key=lambda r: r["bytes"])
+            if points:
+                ax.plot([r["bytes"] for r in points], [r["work"] / r["median"] for r in points], marker="o", markersize=3, label=label)
+        for c in caches:
+            ax.axvline(x=c["size"], color="gray", linestyle=":", linewidth=1)
+            ax.text(c["size"], 1.0, f" L{c['level']}", transform=ax.get_xaxis_transform(), fontsize=7, va="top", color="gray")
+        ax.set_xscale("log", base=2)
+        ax.set_title(kernel)
+        ax.set_xlabel("Empreinte mémoire (octets)")
+        ax.set_ylabel(unit)
+        ax.grid(linestyle="--", alpha=0.6)
+        ax.legend(fontsize=7)
+    json_title(fig, data, "débit selon la taille")
+    save(fig, out_path)
+
+
+def plot_json(data, out_dir):
+    """Figures de la suite csParallelTask_benchmark."""
+    plot_scaling(data, "strong", False, out_dir / "csParallelTask_strong_scaling.png")
+    plot_scaling(data, "strong", True, out_dir / "csParallelTask_efficiency.png")
+    plot_scaling(data, "weak", True, out_dir / "csParallelTask_weak_scaling.png")
+    plot_throughput(data, out_dir / "csParallelTask_throughput.png")
+
+
 def main():
     if len(sys.argv) > 1:
         with open(sys.argv[1], "r", encoding="utf-8", errors="replace") as f:
@@ -223,6 +365,11 @@ def main():
     else:
         text = sys.stdin.read()
 
+    out_dir = Path(sys.argv[2]) if len(sys.argv) > 2 else Path(__file__).resolve().parent.parent
+    if text.lstrip().startswith("{"):
+        plot_json(json.loads(text), out_dir)
+        return
+
     n_threads, N, benchmarks = parse_output(text)
     if n_threads is None:
         n_threads = "?"
@@ -230,7 +377,6 @@ def main():
         N = "?"
 
     machine_info = get_machine_info()
-    out_dir = Path(__file__).resolve().parent.parent
     out_path = out_dir / "csParallelTask_benchmark.png"
     plot_bars(n_threads, N, benchmarks, machine_info, out_path)
 
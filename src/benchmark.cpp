@@ -0,0 +1,608 @@
+/*
+ * Suite de benchmarks de csParallelTask : mise a l'echelle forte (taille fixe, 1 a N threads) et faible (taille
+ * proportionnelle au nombre de threads) des noyaux de main.cpp, du tri et du produit de matrices, pour des tailles
+ * allant du cache L1 a la memoire centrale. Les resultats sont ecrits en JSON pour scripts/plot_benchmark.py.
+ *
+ * Usage: csParallelTask_benchmark [-o benchmark.json] [--quick] [--threads 1,2,4] [--kernels sum,gemm] [--max-mib 256]
+ */
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include "csPargs.h"
+#include "csParallel.h"
+#include "csAffinity.h"
+#include "csBenchmark.h"
+#include "csGemm.h"
+#include "csJsonInternal.h"
+#include "csReduction.h"
+#include "csSimd.h"
+#include "csSort.h"
+
+using namespace std;
+using namespace csParallelTask;
+
+// ---- Parametres ----
+
+typedef struct
+{
+    string output;
+    vector<size_t> threads;
+    vector<string> kernels;
+    size_t minBytes;
+    size_t maxBytes;
+    size_t maxSortBytes;
+    size_t maxGemm;
+    size_t minRepetitions;
+    size_t maxRepetitions;
+    double budgetNs;
+}SETTINGS;
+
+typedef struct
+{
+    int level;
+    string type;
+    size_t size;
+}CACHE_INFO;
+
+// Une mesure : noyau, mode (sequential, strong, weak), threads, taille et statistiques en nanosecondes
+typedef struct
+{
+    string kernel;
+    string mode;
+    size_t threads;
+    size_t size;
+    size_t bytes;
+    size_t perThread;   // mise a l'echelle faible : octets par thread, qui identifient la serie
+    double work;
+    const char* workUnit;
+    CSBENCH_RESULT stats;
+}RECORD;
+
+static SETTINGS settings;
+static vector<RECORD> records;
+static volatile double sink;
+
+// ---- Noyaux paralleles (memes corps que main.cpp) ----
+// Arguments communs : x, y, parametre scalaire, reduction
+
+static void kernel_sum(CSPARGS args) {
+    double* x = args.getArgPtr<double>(0);
+    CSREDUCTION<double>* partial = args.getArgPtr<CSREDUCTION<double>>(3);
+    auto b = args.getBounds();
+    double sum = 0.0;
+    for (size_t i = b.first; i < b.last; i++) sum += x[i];
+    partial->accumulate(args.getBlockId(), sum);
+}
+
+static void kernel_sqsum(CSPARGS args) {
+    double* x = args.getArgPtr<double>(0);
+    CSREDUCTION<double>* partial = args.getArgPtr<CSREDUCTION<double>>(3);
+    auto b = args.getBounds();
+    double sum = 0.0;
+    for (size_t i = b.first; i < b.last; i++) sum += x[i] * x[i];
+    partial->accumulate(args.getBlockId(), sum);
+}
+
+static void kernel_dot(CSPARGS args) {
+    double* x = args.getArgPtr<double>(0);
+    double* y = args.getArgPtr<double>(1);
+    CSREDUCTION<double>* partial = args.getArgPtr<CSREDUCTION<double>>(3);
+    auto b = args.getBounds();
+    double sum = 0.0;
+    for (size_t i = b.first; i < b.last; i++) sum += x[i] * y[i];
+    partial->accumulate(args.getBlockId(), sum);
+}
+
+static void kernel_min(CSPARGS args) {
+    double* x = args.getArgPtr<double>(0);
+    CSREDUCTION<double>* partial = args.getArgPtr<CSREDUCTION<double>>(3);
+    auto b = args.getBounds();
+    double m = x[b.first];
+    for (size_t i = b.first + 1; i < b.last; i++)
+        if (x[i] < m) m = x[i];
+    partial->accumulate(args.getBlockId(), m);
+}
+
+static void kernel_max(CSPARGS args) {
+    double* x = args.getArgPtr<double>(0);
+    CSREDUCTION<double>* partial = args.getArgPtr<CSREDUCTION<double>>(3);
+    auto b = args.getBounds();
+    double m = x[b.first];
+    for (size_t i = b.first + 1; i < b.last; i++)
+        if (x[i] > m) m = x[i];
+    partial->accumulate(args.getBlockId(), m);
+}
+
+static void kernel_scale(CSPARGS args) {
+    double* x = args.getArgPtr<double>(0);
+    double a = *args.getArgPtr<double>(2);
+    auto b = args.getBounds();
+    for (size_t i = b.first; i < b.last; i++) x[i] *= a;
+}
+
+static void kernel_fill(CSPARGS args) {
+    double* x = args.getArgPtr<double>(0);
+    double v = *args.getArgPtr<double>(2);
+    auto b = args.getBounds();
+    for (size_t i = b.first; i < b.last; i++) x[i] = v;
+}
+
+static void kernel_axpy(CSPARGS args) {
+    double* x = args.getArgPtr<double>(0);
+    double* y = args.getArgPtr<double>(1);
+    double a = *args.getArgPtr<double>(2);
+    auto b = args.getBounds();
+    for (size_t i = b.first; i < b.last; i++) y[i] = a * x[i] + y[i];
+}
+
+// ---- Versions sequentielles ----
+
+static void seq_sum(double* x, double*, double, size_t n) { double s = 0.0; for (size_t i = 0; i < n; i++) s += x[i]; sink = s; }
+static void seq_sqsum(double* x, double*, double, size_t n) { double s = 0.0; for (size_t i = 0; i < n; i++) s += x[i] * x[i]; sink = s; }
+static void seq_dot(double* x, double* y, double, size_t n) { double s = 0.0; for (size_t i = 0; i < n; i++) s += x[i] * y[i]; sink = s; }
+static void seq_min(double* x, double*, double, size_t n) { double m = x[0]; for (size_t i = 1; i < n; i++) if (x[i] < m) m = x[i]; sink = m; }
+static void seq_max(double* x, double*, double, size_t n) { double m = x[0]; for (size_t i = 1; i < n; i++) if (x[i] > m) m = x[i]; sink = m; }
+static void seq_scale(double* x, double*, double a, size_t n) { for (size_t i = 0; i < n; i++) x[i] *= a; }
+static void seq_fill(double* x, double*, double v, size_t n) { for (size_t i = 0; i < n; i++) x[i] = v; }
+static void seq_axpy(double* x, double* y, double a, size_t n) { for (size_t i = 0; i < n; i++) y[i] = a * x[i] + y[i]; }
+
+typedef double(*REDUCE_OP)(double, double);
+
+typedef struct
+{
+    const char* name;
+    void (*kernel)(CSPARGS);
+    void (*sequential)(double*, double*, double, size_t);
+    size_t arrays;      // tableaux de n doubles : empreinte memoire
+    size_t traffic;     // octets lus et ecrits par element
+    double param;
+    REDUCE_OP reduce;   // 0 si le noyau ne reduit pas
+    double identity;
+}KERNEL_DESC;
+
+static const KERNEL_DESC KERNELS[] = {
+    {"sum",   kernel_sum,   seq_sum,   1,  8, 0.0,    csReduceSum<double>, 0.0},
+    {"sqsum", kernel_sqsum, seq_sqsum, 1,  8, 0.0,    csReduceSum<double>, 0.0},
+    {"dot",   kernel_dot,   seq_dot,   2, 16, 0.0,    csReduceSum<double>, 0.0},
+    {"min",   kernel_min,   seq_min,   1,  8, 0.0,    csReduceMin<double>, 1e300},
+    {"max",   kernel_max,   seq_max,   1,  8, 0.0,    csReduceMax<double>, -1e300},
+    // Facteur 1 et alpha minuscule : les valeurs restent stables quel que soit le nombre d'executions
+    {"scale", kernel_scale, seq_scale, 1, 16, 1.0,    0, 0.0},
+    {"fill",  kernel_fill,  seq_fill,  1,  8, 3.14,   0, 0.0},
+    {"axpy",  kernel_axpy,  seq_axpy,  2, 24, 1e-12,  0, 0.0},
+};
+
+// ---- Mesure ----
+
+static bool selected(const char* kernel)
+{
+    return settings.kernels.empty() || find(settings.kernels.begin(), settings.kernels.end(), kernel) != settings.kernels.end();
+}
+
+static size_t repetitionsFor(double onceNs)
+{
+    double r = settings.budgetNs / max(onceNs, 1.0);
+    return (size_t)min((double)settings.maxRepetitions, max((double)settings.minRepetitions, r));
+}
+
+// Un premier appel (compte comme echauffement) fixe le nombre d'echantillons pour tenir dans le budget de temps
+static CSBENCH_RESULT measure(const string& name, const function<void()>& f)
+{
+    CSPERF_CHECKER perf(CSTIME_UNIT_NANOSECOND);
+    perf.start();
+    f();
+    perf.stop();
+    CSBENCHMARK bench(repetitionsFor((double)perf.getEllapsedNanoseconds()), 1);
+    return bench.run(name.c_str(), f);
+}
+
+// Variante ou chaque echantillon part de donnees preparees hors de la mesure (tri)
+static CSBENCH_RESULT measurePrepared(const string& name, const function<void()>& prepare, const function<void()>& f)
+{
+    CSPERF_CHECKER perf(CSTIME_UNIT_NANOSECOND);
+    prepare();
+    perf.start();
+    f();
+    perf.stop();
+    size_t reps = repetitionsFor((double)perf.getEllapsedNanoseconds());
+    vector<double> samples;
+    for (size_t r = 0; r < reps; r++)
+    {
+        prepare();
+        perf.start();
+        f();
+        perf.stop();
+        samples.push_back((double)perf.getEllapsedNanoseconds());
+    }
+    CSBENCHMARK bench;
+    CSBENCH_RESULT result = bench.computeStatistics(name.c_str(), samples);
+    result.warmup = 1;
+    return result;
+}
+
+static void record(const char* kernel, const char* mode, size_t threads, size_t size, size_t bytes, size_t perThread, double work,
+                   const char* workUnit, const CSBENCH_RESULT& stats)
+{
+    RECORD r = {kernel, mode, threads, size, bytes, perThread, work, workUnit, stats};
+    records.push_back(r);
+    cout << "  " << left << setw(6) << kernel << setw(11) << mode << right << setw(4) << threads << " threads" << setw(12) << size
+         << setw(10) << bytes / 1024 << " KiB" << fixed << setprecision(1) << setw(14) << stats.median / 1000.0 << " us";
+    if (stats.median > 0.0)
+        cout << setw(10) << setprecision(2) << work / stats.median << (strcmp(workUnit, "flops") == 0 ? " GFLOP/s" : " GB/s");
+    cout << "\n";
+}
+
+// Le thread appelant execute un bloc : t threads = t-1 workers et t blocs
+static void useThreads(size_t t)
+{
+    getThreadPool()->start(t - 1);
+}
+
+// ---- Noyaux elementaires ----
+
+static void runElementKernel(const KERNEL_DESC& k, size_t n, const vector<size_t>& threads, const char* mode, size_t perThread)
+{
+    vector<double> x(n), y(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        x[i] = sin(0.001 * i) + cos(0.002 * i);
+        y[i] = 1.0 / (1 + i % 100);
+    }
+    double param = k.param;
+    size_t bytes = n * k.arrays * sizeof(double);
+    double traffic = (double)n * k.traffic;
+
+    if (perThread == 0)
+    {
+        record(k.name, "sequential", 1, n, bytes, 0, traffic, "bytes",
+               measure(k.name, [&]() { k.sequential(x.data(), y.data(), param, n); }));
+    }
+    for (size_t t : threads)
+    {
+        useThreads(t);
+        CSREDUCTION<double> red;
+        size_t id = registerFunctionRegularEx(t, n, k.name, k.kernel, x.data(), y.data(), &param, &red);
+        red.init(getBlockNumber(id), k.identity, k.reduce ? k.reduce : csReduceSum<double>);
+        CSBENCH_RESULT stats = measure(k.name, [&]() {
+            if (k.reduce)
+                red.reset();
+            execute(id);
+            if (k.reduce)
+                sink = red.combine();
+        });
+        unregisterFunction(id);
+        record(k.name, mode, t, n, bytes, perThread, traffic, "bytes", stats);
+    }
+}
+
+// ---- Tri ----
+
+static void runSort(size_t n, const vector<size_t>& threads, const char* mode, size_t perThread)
+{
+    vector<double> source(n), keys(n);
+    mt19937_64 gen(42);
+    uniform_real_distribution<double> dist(-1.0, 1.0);
+    for (size_t i = 0; i < n; i++) source[i] = dist(gen);
+    size_t bytes = n * sizeof(double);
+    auto prepare = [&]() { copy(source.begin(), source.end(), keys.begin()); };
+
+    if (perThread == 0)
+        record("sort", "sequential", 1, n, bytes, 0, (double)bytes, "bytes",
+               measurePrepared("sort", prepare, [&]() { sort(keys.begin(), keys.end()); }));
+    for (size_t t : threads)
+    {
+        useThreads(t);
+        record("sort", mode, t, n, bytes, perThread, (double)bytes, "bytes",
+               measurePrepared("sort", prepare, [&]() { parallel_sort(keys.begin(), keys.end()); }));
+    }
+}
+
+// ---- Produit de matrices ----
+
+static void runGemm(size_t M, size_t N, size_t K, const vector<size_t>& threads, const char* mode, size_t perThread)
+{
+    vector<double> A(M * K), B(K * N), C(M * N);
+    for (size_t i = 0; i < A.size(); i++) A[i] = sin(0.01 * i);
+    for (size_t i = 0; i < B.size(); i++) B[i] = cos(0.01 * i);
+    size_t bytes = (A.size() + B.size() + C.size()) * sizeof(double);
+    double flops = 2.0 * M * N * K;
+    for (size_t t : threads)
+    {
+        useThreads(t);
+        record("gemm", mode, t, K, bytes, perThread, flops, "flops",
+               measure("gemm", [&]() { matrixMultiply(M, N, K, A.data(), B.data(), C.data()); }));
+    }
+}
+
+// ---- Informations machine ----
+
+static string readFirstLine(const string& path)
+{
+    ifstream in(path);
+    string line;
+    getline(in, line);
+    return line;
+}
+
+static string cpuName()
+{
+#ifdef __linux__
+    ifstream in("/proc/cpuinfo");
+    string line;
+    while (getline(in, line))
+    {
+        if (line.compare(0, 10, "model name") == 0 && line.find(':') != string::npos)
+            return line.substr(line.find(':') + 2);
+    }
+#endif
+    return "unknown";
+}
+
+static vector<CACHE_INFO> cpuCaches()
+{
+    vector<CACHE_INFO> caches;
+#ifdef __linux__
+    for (int i = 0; ; i++)
+    {
+        string dir = "/sys/devices/system/cpu/cpu0/cache/index" + to_string(i) + "/";
+        string level = readFirstLine(dir + "level");
+        if (level.empty())
+            break;
+        // Taille au format "32K" ou "8192K"
+        string size = readFirstLine(dir + "size");
+        size_t value = strtoul(size.c_str(), 0, 10);
+        if (!size.empty() && size.back() == 'K') value *= 1024;
+        if (!size.empty() && size.back() == 'M') value *= 1024 * 1024;
+        CACHE_INFO c = {atoi(level.c_str()), readFirstLine(dir + "type"), value};
+        caches.push_back(c);
+    }
+#endif
+    return caches;
+}
+
+static string compilerName()
+{
+#if defined(__clang__)
+    return string("clang ") + __clang_version__;
+#elif defined(__GNUC__)
+    return string("gcc ") + __VERSION__;
+#elif defined(_MSC_VER)
+    return "msvc " + to_string(_MSC_VER);
+#else
+    return "unknown";
+#endif
+}
+
+static string systemName()
+{
+#if defined(_WIN32)
+    return "Windows";
+#elif defined(__linux__)
+    return "Linux";
+#elif defined(__APPLE__)
+    return "macOS";
+#else
+    return "unknown";
+#endif
+}
+
+// ---- Sortie JSON ----
+
+static bool writeJson(const string& path, const vector<CACHE_INFO>& caches)
+{
+    ofstream out(path);
+    if (!out.is_open())
+    {
+        cout << "cannot write benchmark file !\n";
+        return false;
+    }
+    out << "{\n  \"machine\": {\"cpu\": ";
+    writeJsonString(out, cpuName());
+    out << ", \"system\": ";
+    writeJsonString(out, systemName());
+    out << ", \"compiler\": ";
+    writeJsonString(out, compilerName());
+    out << ",\n    \"hardwareConcurrency\": " << getHardwareConcurrency() << ", \"availableConcurrency\": " << getAvailableConcurrency()
+        << ", \"numaNodes\": " << getNumaNodeNumber() << ", \"simd\": ";
+    writeJsonString(out, getSimdLevelName(getSimdLevel()));
+    out << ",\n    \"caches\": [";
+    for (size_t i = 0; i < caches.size(); i++)
+    {
+        out << (i ? ", " : "") << "{\"level\": " << caches[i].level << ", \"type\": ";
+        writeJsonString(out, caches[i].type);
+        out << ", \"size\": " << caches[i].size << "}";
+    }
+    out << "]},\n  \"settings\": {\"threads\": [";
+    for (size_t i = 0; i < settings.threads.size(); i++)
+        out << (i ? ", " : "") << settings.threads[i];
+    out << "], \"minRepetitions\": " << settings.minRepetitions << ", \"maxRepetitions\": " << settings.maxRepetitions
+        << ", \"outlierFilter\": \"mad\", \"unit\": \"ns\"},\n  \"results\": [";
+    out << fixed << setprecision(1);
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        const RECORD& r = records[i];
+        out << (i ? ",\n" : "\n") << "    {\"kernel\": \"" << r.kernel << "\", \"mode\": \"" << r.mode << "\", \"threads\": " << r.threads
+            << ", \"size\": " << r.size << ", \"bytes\": " << r.bytes << ", \"perThread\": " << r.perThread << ", \"work\": " << r.work << ", \"workUnit\": \"" << r.workUnit
+            << "\", \"repetitions\": " << r.stats.repetitions << ", \"outliers\": " << r.stats.outliers
+            << ", \"min\": " << r.stats.min << ", \"median\": " << r.stats.median << ", \"mean\": " << r.stats.mean
+            << ", \"p95\": " << r.stats.p95 << ", \"p99\": " << r.stats.p99 << ", \"stddev\": " << r.stats.stddev << "}";
+    }
+    out << "\n  ]\n}\n";
+    return out.good();
+}
+
+// ---- Ligne de commande ----
+
+static vector<string> splitList(const string& text)
+{
+    vector<string> items;
+    stringstream ss(text);
+    string item;
+    while (getline(ss, item, ','))
+        if (!item.empty()) items.push_back(item);
+    return items;
+}
+
+// Entier decimal sans signe : faux pour un texte vide, non numerique ou trop grand
+static bool parseCount(const string& text, size_t& value)
+{
+    if (text.empty() || text.find_first_not_of("0123456789") != string::npos)
+        return false;
+    try
+    {
+        value = stoul(text);
+    }
+    catch (const out_of_range&)
+    {
+        return false;
+    }
+    return true;
+}
+
+static bool parseArguments(int argc, char** argv)
+{
+    size_t maxThreads = getAvailableConcurrency();
+    size_t llc = 0;
+    for (const CACHE_INFO& c : cpuCaches())
+        llc = max(llc, c.size);
+
+    settings.output = "benchmark.json";
+    settings.minBytes = 16 * 1024;
+    // Au moins 8 fois le dernier niveau de cache pour que la plus grande taille sorte de tous les caches
+    settings.maxBytes = max((size_t)64 << 20, min((size_t)1 << 30, 8 * llc));
+    settings.maxSortBytes = (size_t)64 << 20;
+    settings.maxGemm = 1024;
+    settings.minRepetitions = 5;
+    settings.maxRepetitions = 30;
+    settings.budgetNs = 2e8;
+
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        bool valid = true;
+        size_t n = 0;
+        if (arg == "-o" && hasValue)
+            settings.output = argv[++i];
+        else if (arg == "--quick")
+        {
+            settings.maxBytes = (size_t)16 << 20;
+            settings.maxSortBytes = (size_t)4 << 20;
+            settings.maxGemm = 256;
+            settings.minRepetitions = 3;
+            settings.maxRepetitions = 10;
+            settings.budgetNs = 2e7;
+        }
+        else if (arg == "--threads" && hasValue)
+        {
+            for (const string& t : splitList(argv[++i]))
+            {
+                if (!parseCount(t, n))
+                    valid = false;
+                settings.threads.push_back(max((size_t)1, min(maxThreads, n)));
+            }
+        }
+        else if (arg == "--kernels" && hasValue)
+            settings.kernels = splitList(argv[++i]);
+        else if (arg == "--max-mib" && hasValue)
+        {
+            valid = parseCount(argv[++i], n);
+            settings.maxBytes = n << 20;
+        }
+        else
+            valid = false;
+
+        if (!valid)
+        {
+            cout << "usage: " << argv[0] << " [-o file.json] [--quick] [--threads 1,2,4] [--kernels sum,sort,gemm] [--max-mib 256]\n";
+            return false;
+        }
+    }
+    settings.maxSortBytes = min(settings.maxSortBytes, settings.maxBytes);
+
+    // Puissances de deux jusqu'au maximum, plus le maximum lui-meme
+    if (settings.threads.empty())
+    {
+        for (size_t t = 1; t < maxThreads; t *= 2)
+            settings.threads.push_back(t);
+        settings.threads.push_back(maxThreads);
+    }
+    sort(settings.threads.begin(), settings.threads.end());
+    settings.threads.erase(unique(settings.threads.begin(), settings.threads.end()), settings.threads.end());
+    return true;
+}
+
+int main(int argc, char** argv) {
+    if (!parseArguments(argc, argv))
+        return 1;
+    vector<CACHE_INFO> caches = cpuCaches();
+    size_t maxThreads = settings.threads.back();
+    cout << "csParallelTask benchmark - " << cpuName() << ", threads up to " << maxThreads << ", sizes "
+         << settings.minBytes / 1024 << " KiB to " << settings.maxBytes / 1024 << " KiB\n";
+
+    // Mise a l'echelle forte : taille fixe du cache L1 a la memoire centrale, de 1 a N threads
+    for (const KERNEL_DESC& k : KERNELS)
+    {
+        if (!selected(k.name))
+            continue;
+        for (size_t bytes = settings.minBytes; bytes <= settings.maxBytes; bytes *= 4)
+            runElementKernel(k, bytes / (k.arrays * sizeof(double)), settings.threads, "strong", 0);
+    }
+    if (selected("sort"))
+    {
+        for (size_t bytes = settings.minBytes; bytes <= settings.maxSortBytes; bytes *= 4)
+            runSort(bytes / sizeof(double), settings.threads, "strong", 0);
+    }
+    if (selected("gemm"))
+    {
+        for (size_t m = 32; m <= settings.maxGemm && 3 * m * m * sizeof(double) <= settings.maxBytes; m *= 2)
+            runGemm(m, m, m, settings.threads, "strong", 0);
+    }
+
+    // Mise a l'echelle faible : une part fixe par thread, dans le cache L2 puis en memoire centrale
+    for (size_t perThread : {(size_t)256 * 1024, max((size_t)1 << 20, settings.maxBytes / maxThreads)})
+    {
+        for (size_t t : settings.threads)
+        {
+            if (perThread * t > settings.maxBytes)
+                continue;
+            vector<size_t> one(1, t);
+            for (const KERNEL_DESC& k : KERNELS)
+            {
+                if (selected(k.name))
+                    runElementKernel(k, perThread * t / (k.arrays * sizeof(double)), one, "weak", perThread);
+            }
+            if (selected("sort") && perThread * t <= settings.maxSortBytes)
+                runSort(perThread * t / sizeof(double), one, "weak", perThread);
+        }
+    }
+    // Produit de matrices : M croit avec le nombre de threads, le travail par thread reste 2 x 128 x m x m
+    if (selected("gemm"))
+    {
+        for (size_t m : {(size_t)128, (size_t)512})
+        {
+            if (m > settings.maxGemm)
+                continue;
+            for (size_t t : settings.threads)
+            {
+                if ((128 * t * m + m * m + 128 * t * m) * sizeof(double) <= settings.maxBytes)
+                    runGemm(128 * t, m, m, vector<size_t>(1, t), "weak", 2 * 128 * m * sizeof(double));
+            }
+        }
+    }
+
+    getThreadPool()->start(getAvailableConcurrency());
+    if (!writeJson(settings.output, caches))
+        return 1;
+    cout << records.size() << " measurements written to " << settings.output << "\n";
+    return 0;
+}
@@ -0,0 +1,309 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include "csAffinity.h"
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace std;
+
+typedef struct
+{
+  size_t cpu;
+  size_t node;
+  size_t core;
+}CPU_INFO;
+
+// Liste au format du noyau, par exemple "0-3,8-11"
+static vector<size_t> parseCpuList(const string& text)
+{
+  vector<size_t> cpus;
+  stringstream ss(text);
+  string range;
+  while (getline(ss, range, ','))
+  {
+    if (range.empty() || range[0] < '0' || range[0] > '9')
+      continue;
+    size_t dash = range.find('-');
+    size_t first = stoul(range.substr(0, dash));
+    size_t last = dash == string::npos ? first : stoul(range.substr(dash+1));
+    for(size_t c=first; c<=last; c++)
+      cpus.push_back(c);
+  }
+  return cpus;
+}
+
+static bool readLine(const string& path, string& line)
+{
+  ifstream f(path);
+  return f && getline(f, line);
+}
+
+typedef struct
+{
+  vector<size_t> nodes;
+  size_t count;
+}NODE_TABLE;
+
+static NODE_TABLE readNodeTable()
+{
+  NODE_TABLE table;
+  table.count = 0;
+  string line;
+  for(size_t n=0; n<1024 && readLine("/sys/devices/system/node/node" + to_string(n) + "/cpulist", line); n++)
+  {
+    for(size_t cpu : parseCpuList(line))
+    {
+      if (cpu >= table.nodes.size())
+        table.nodes.resize(cpu+1, 0);
+      table.nodes[cpu] = n;
+    }
+    table.count = n+1;
+  }
+  if (table.count == 0)
+    table.count = 1;
+  return table;
+}
+
+// Noeud NUMA de chaque CPU, lu une fois dans sysfs (statique locale : initialisee une seule fois meme en concurrence)
+static const vector<size_t>& cpuNodes(size_t* nNodes)
+{
+  static const NODE_TABLE table = readNodeTable();
+  *nNodes = table.count;
+  return table.nodes;
+}
+
+static size_t cpuCore(size_t cpu)
+{
+  string line;
+  if (readLine("/sys/devices/system/cpu/cpu" + to_string(cpu) + "/topology/core_id", line))
+    return stoul(line);
+  return cpu;
+}
+
+vector<size_t> CS_PARALLEL_TASK_API csParallelTask::getAvailableCpus()
+{
+  vector<size_t> cpus;
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set) == 0)
+  {
+    for(size_t c=0; c<CPU_SETSIZE; c++)
+    {
+      if (CPU_ISSET(c, &set))
+        cpus.push_back(c);
+    }
+  }
+#endif
+  if (cpus.empty())
+  {
+    size_t n = std::max(1u, std::thread::hardware_concurrency());
+    for(size_t c=0; c<n; c++)
+      cpus.push_back(c);
+  }
+  return cpus;
+}
+
+// Chemin du cgroup du processus pour un controleur ("" pour cgroup v2), lu dans /proc/self/cgroup
+static bool cgroupPath(const string& controller, string& path)
+{
+  ifstream f("/proc/self/cgroup");
+  string line;
+  while (f && getline(f, line))
+  {
+    size_t c1 = line.find(':');
+    size_t c2 = c1 == string::npos ? string::npos : line.find(':', c1+1);
+    if (c2 == string::npos)
+      continue;
+    string list = "," + line.substr(c1+1, c2-c1-1) + ",";
+    if ((controller.empty() && c2 == c1+1) || (!controller.empty() && list.find("," + controller + ",") != string::npos))
+    {
+      path = line.substr(c2+1);
+      return true;
+    }
+  }
+  return false;
+}
+
+// Plus petit quota de la hierarchie, du cgroup du processus jusqu'a la racine du point de montage
+static double cgroupQuota(const string& mount, string path, bool v2)
+{
+  double quota = 0;
+  for(;;)
+  {
+    string dir = mount + (path == "/" ? "" : path);
+    string line;
+    double q = 0;
+    if (v2)
+    {
+      if (readLine(dir + "/cpu.max", line) && line.compare(0, 3, "max") != 0)
+      {
+        double max = 0, period = 0;
+        stringstream ss(line);
+        if ((ss >> max >> period) && max > 0 && period > 0)
+          q = max/period;
+      }
+    }
+    else
+    {
+      string period;
+      if (readLine(dir + "/cpu.cfs_quota_us", line) && readLine(dir + "/cpu.cfs_period_us", period))
+      {
+        double max = atof(line.c_str()), p = atof(period.c_str());
+        if (max > 0 && p > 0)
+          q = max/p;
+      }
+    }
+    if (q > 0 && (quota == 0 || q < quota))
+      quota = q;
+
+    if (path.empty() || path == "/")
+      break;
+    size_t slash = path.find_last_of('/');
+    path = slash == 0 || slash == string::npos ? "/" : path.substr(0, slash);
+  }
+  return quota;
+}
+
+size_t CS_PARALLEL_TASK_API csParallelTask::getCpuQuota()
+{
+  double quota = 0;
+#ifdef __linux__
+  string path;
+  if (cgroupPath("", path))
+    quota = cgroupQuota("/sys/fs/cgroup", path, true);
+  // Dans un conteneur, le cgroup est souvent monte a la racine : le chemin vu dans /proc n'existe pas
+  if (quota == 0)
+    quota = cgroupQuota("/sys/fs/cgroup", "/", true);
+  if (quota == 0 && cgroupPath("cpu", path))
+  {
+    for(const char* mount : {"/sys/fs/cgroup/cpu,cpuacct", "/sys/fs/cgroup/cpu"})
+    {
+      quota = cgroupQuota(mount, path, false);
+      if (quota == 0)
+        quota = cgroupQuota(mount, "/", false);
+      if (quota > 0)
+        break;
+    }
+  }
+#endif
+  if (quota <= 0)
+    return 0;
+  return std::max((size_t)1, (size_t)ceil(quota - 0.01));
+}
+
+static size_t computeConcurrency()
+{
+  size_t n = 0;
+  const char* env = getenv(CSPARALLEL_THREADS_ENV);
+  if (env && atol(env) > 0)
+    n = (size_t)atol(env);
+  else
+  {
+    n = csParallelTask::getAvailableCpus().size();
+    size_t quota = csParallelTask::getCpuQuota();
+    if (quota > 0)
+      n = std::min(n, quota);
+  }
+  return std::max((size_t)1, n);
+}
+
+size_t CS_PARALLEL_TASK_API csParallelTask::getAvailableConcurrency()
+{
+  // Calcule une seule fois, meme si plusieurs threads appellent en meme temps
+  static const size_t concurrency = computeConcurrency();
+  return concurrency;
+}
+
+size_t CS_PARALLEL_TASK_API csParallelTask::getNumaNodeNumber()
+{
+  size_t nNodes;
+  cpuNodes(&nNodes);
+  return nNodes;
+}
+
+size_t CS_PARALLEL_TASK_API csParallelTask::getCpuNode(size_t cpu)
+{
+  size_t nNodes;
+  const vector<size_t>& nodes = cpuNodes(&nNodes);
+  return cpu < nodes.size() ? nodes[cpu] : 0;
+}
+
+vector<size_t> CS_PARALLEL_TASK_API csParallelTask::getCpuOrder(int policy)
+{
+  vector<size_t> cpus = getAvailableCpus();
+  if (policy != CSAFFINITY_COMPACT && policy != CSAFFINITY_SCATTER)
+    return cpus;
+
+  vector<CPU_INFO> info;
+  for(size_t cpu : cpus)
+  {
+    info.push_back({cpu, getCpuNode(cpu), cpuCore(cpu)});
+  }
+  std::sort(info.begin(), info.end(), [](const CPU_INFO& a, const CPU_INFO& b)
+  {
+    if (a.node != b.node) return a.node < b.node;
+    if (a.core != b.core) return a.core < b.core;
+    return a.cpu < b.cpu;
+  });
+
+  vector<size_t> order;
+  if (policy == CSAFFINITY_COMPACT)
+  {
+    for(const CPU_INFO& c : info)
+      order.push_back(c.cpu);
+    return order;
+  }
+
+  // Par noeud : d'abord un hyper-thread par coeur, puis les suivants
+  size_t nNodes = getNumaNodeNumber();
+  vector<vector<size_t>> perNode(nNodes);
+  vector<vector<size_t>> siblings(nNodes);
+  for(size_t i=0; i<info.size(); i++)
+  {
+    size_t node = std::min(info[i].node, nNodes-1);
+    bool first = i == 0 || info[i-1].node != info[i].node || info[i-1].core != info[i].core;
+    (first ? perNode[node] : siblings[node]).push_back(info[i].cpu);
+  }
+  for(size_t n=0; n<nNodes; n++)
+    perNode[n].insert(perNode[n].end(), siblings[n].begin(), siblings[n].end());
+
+  for(size_t k=0; order.size()<info.size(); k++)
+  {
+    for(size_t n=0; n<nNodes; n++)
+    {
+      if (k < perNode[n].size())
+        order.push_back(perNode[n][k]);
+    }
+  }
+  return order;
+}
+
+bool CS_PARALLEL_TASK_API csParallelTask::pinThread(std::thread::native_handle_type thread, size_t cpu)
+{
+  return pinThread(thread, vector<size_t>(1, cpu));
+}
+
+bool CS_PARALLEL_TASK_API csParallelTask::pinThread(std::thread::native_handle_type thread, const vector<size_t>& cpus)
+{
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for(size_t cpu : cpus)
+  {
+    if (cpu < CPU_SETSIZE)
+      CPU_SET(cpu, &set);
+  }
+  if (CPU_COUNT(&set) == 0)
+    return false;
+  return pthread_setaffinity_np(thread, sizeof(set), &set) == 0;
+#else
+  return false;
+#endif
+}
@@ -0,0 +1,323 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include "csBenchmark.h"
+#include "csParallel.h"
+#include "csJsonInternal.h"
+
+using namespace std;
+
+static const char* COUNTER_KEYS[CSPERF_COUNTER_NUMBER] = {"cycles", "instructions", "llcMisses", "branchMisses", "stalledCycles"};
+
+// Percentile par interpolation lineaire entre les deux echantillons tries les plus proches
+static double percentile(const vector<double>& sorted, double p)
+{
+  if (sorted.empty())
+    return 0.0;
+  double pos = p*(sorted.size() - 1);
+  size_t i = (size_t)pos;
+  if (i + 1 >= sorted.size())
+    return sorted.back();
+  return sorted[i] + (pos - i)*(sorted[i+1] - sorted[i]);
+}
+
+static double unitScale(int unit)
+{
+  static const double scales[] = {3.6e12, 6e10, 1e9, 1e6, 1e3, 1.0};
+  return unit >= CSTIME_UNIT_HOUR && unit <= CSTIME_UNIT_NANOSECOND ? scales[unit] : 1e3;
+}
+
+static const char* unitSymbol(int unit)
+{
+  static const char* symbols[] = {"h", "min", "s", "ms", "us", "ns"};
+  return unit >= CSTIME_UNIT_HOUR && unit <= CSTIME_UNIT_NANOSECOND ? symbols[unit] : "us";
+}
+
+CSBENCHMARK::CSBENCHMARK(size_t _repetitions, size_t _warmup)
+{
+  setRepetitions(_repetitions);
+  setWarmup(_warmup);
+}
+
+void CSBENCHMARK::setRepetitions(size_t _repetitions)
+{
+  repetitions = _repetitions > 0 ? _repetitions : 1;
+}
+
+void CSBENCHMARK::setWarmup(size_t _warmup)
+{
+  warmup = _warmup;
+}
+
+void CSBENCHMARK::setOutlierFilter(int filter, double threshold)
+{
+  if (filter != CSBENCH_OUTLIER_NONE && filter != CSBENCH_OUTLIER_MAD && filter != CSBENCH_OUTLIER_IQR)
+  {
+    cout<<"invalid outlier filter !\n";
+    return;
+  }
+  outlierFilter = filter;
+  if (threshold > 0.0)
+    outlierThreshold = threshold;
+  else
+    outlierThreshold = filter == CSBENCH_OUTLIER_IQR ? CSBENCH_IQR_THRESHOLD : CSBENCH_MAD_THRESHOLD;
+}
+
+void CSBENCHMARK::setMinSampleTime(double ns)
+{
+  minSampleTime = ns > 0.0 ? ns : 0.0;
+}
+
+void CSBENCHMARK::setTimeUnit(int _unit)
+{
+  unit = _unit;
+}
+
+void CSBENCHMARK::setCounterMode(int mode)
+{
+  counterMode = mode;
+}
+
+CSBENCH_RESULT CSBENCHMARK::run(const char* name, const std::function<void()>& func)
+{
+  CSPERF_CHECKER perf(CSTIME_UNIT_NANOSECOND);
+
+  // Echauffement : la derniere execution donne la duree qui fixe la taille des lots
+  double single = 0.0;
+  for(size_t w=0; w<warmup; w++)
+  {
+    perf.start();
+    func();
+    perf.stop();
+    single = (double)perf.getEllapsedNanoseconds();
+  }
+  size_t batch = 1;
+  if (warmup > 0 && single < minSampleTime)
+    batch = (size_t)ceil(minSampleTime / max(single, 1.0));
+
+  perf.setCounterMode(counterMode);
+  vector<double> samples;
+  samples.reserve(repetitions);
+  CSPERF_COUNTERS total;
+  memset(&total, 0, sizeof(total));
+  bool counted = counterMode != CSPERF_COUNTERS_OFF;
+  for(size_t r=0; r<repetitions; r++)
+  {
+    perf.start();
+    for(size_t b=0; b<batch; b++)
+      func();
+    perf.stop();
+    samples.push_back((double)perf.getEllapsedNanoseconds() / batch);
+
+    // Un compteur n'est garde que s'il a ete lu a chaque echantillon
+    if (counted)
+    {
+      CSPERF_COUNTERS c = perf.getCounters();
+      for(int k=0; k<CSPERF_COUNTER_NUMBER; k++)
+      {
+        total.value[k] += c.value[k];
+        total.available[k] = (r == 0 || total.available[k]) && c.available[k];
+      }
+      total.threads = c.threads;
+      counted = perf.hasCounters();
+    }
+  }
+
+  CSBENCH_RESULT result = computeStatistics(name, samples);
+  result.warmup = warmup;
+  result.batch = batch;
+  if (counted)
+  {
+    result.hasCounters = true;
+    result.counters = total;
+    for(int k=0; k<CSPERF_COUNTER_NUMBER; k++)
+      result.counters.value[k] = total.available[k] ? total.value[k] / (repetitions*batch) : 0;
+  }
+  results.push_back(result);
+  return result;
+}
+
+CSBENCH_RESULT CSBENCHMARK::runFunction(const char* name, size_t idf)
+{
+  return run(name, [idf]() { csParallelTask::execute(idf); });
+}
+
+CSBENCH_RESULT CSBENCHMARK::computeStatistics(const char* name, const std::vector<double>& samples)
+{
+  CSBENCH_RESULT r;
+  r.name = name ? name : "";
+  r.warmup = 0;
+  r.repetitions = samples.size();
+  r.batch = 1;
+  r.kept = 0;
+  r.outliers = 0;
+  r.min = r.max = r.median = r.mean = r.p95 = r.p99 = r.stddev = 0.0;
+  r.samples = samples;
+  r.hasCounters = false;
+  memset(&r.counters, 0, sizeof(r.counters));
+  if (samples.empty())
+    return r;
+
+  vector<double> sorted = samples;
+  sort(sorted.begin(), sorted.end());
+  double median = percentile(sorted, 0.5);
+
+  double lo = -numeric_limits<double>::infinity();
+  double hi = numeric_limits<double>::infinity();
+  if (outlierFilter == CSBENCH_OUTLIER_MAD)
+  {
+    // 1.4826 x MAD estime l'ecart type d'une loi normale sans etre tire par les queues
+    vector<double> dev(sorted.size());
+    for(size_t i=0; i<sorted.size(); i++)
+      dev[i] = fabs(sorted[i] - median);
+    sort(dev.begin(), dev.end());
+    double mad = 1.4826*percentile(dev, 0.5);
+    if (mad > 0.0)
+    {
+      lo = median - outlierThreshold*mad;
+      hi = median + outlierThreshold*mad;
+    }
+  }
+  else if (outlierFilter == CSBENCH_OUTLIER_IQR)
+  {
+    double q1 = percentile(sorted, 0.25);
+    double q3 = percentile(sorted, 0.75);
+    lo = q1 - outlierThreshold*(q3 - q1);
+    hi = q3 + outlierThreshold*(q3 - q1);
+  }
+
+  vector<double> kept;
+  kept.reserve(sorted.size());
+  for(double s : sorted)
+  {
+    if (s >= lo && s <= hi)
+      kept.push_back(s);
+  }
+  r.kept = kept.size();
+  r.outliers = sorted.size() - kept.size();
+
+  double sum = 0.0;
+  for(double s : kept)
+    sum += s;
+  r.mean = sum / kept.size();
+  double var = 0.0;
+  for(double s : kept)
+    var += (s - r.mean)*(s - r.mean);
+  r.stddev = kept.size() > 1 ? sqrt(var / (kept.size() - 1)) : 0.0;
+  r.min = kept.front();
+  r.max = kept.back();
+  r.median = percentile(kept, 0.5);
+  r.p95 = percentile(kept, 0.95);
+  r.p99 = percentile(kept, 0.99);
+  return r;
+}
+
+const std::vector<CSBENCH_RESULT>& CSBENCHMARK::getResults()
+{
+  return results;
+}
+
+void CSBENCHMARK::clear()
+{
+  results.clear();
+}
+
+void CSBENCHMARK::printReport()
+{
+  double scale = unitScale(unit);
+  string u = string(" (") + unitSymbol(unit) + ")";
+  size_t width = 9;
+  for(const CSBENCH_RESULT& r : results)
+    width = max(width, r.name.size() + 2);
+
+  cout<<left<<setw(width)<<"benchmark"<<right;
+  for(const char* column : {"min", "median", "mean", "p95", "p99", "stddev"})
+    cout<<setw(14)<<(column + u);
+  cout<<setw(11)<<"outliers"<<setw(12)<<"speedup"<<"\n";
+
+  ios::fmtflags flags = cout.flags();
+  streamsize precision = cout.precision();
+  cout<<fixed<<setprecision(3);
+  for(const CSBENCH_RESULT& r : results)
+  {
+    cout<<left<<setw(width)<<r.name<<right;
+    for(double v : {r.min, r.median, r.mean, r.p95, r.p99, r.stddev})
+      cout<<setw(14)<<v / scale;
+    cout<<setw(11)<<(to_string(r.outliers) + "/" + to_string(r.repetitions));
+    if (r.median > 0.0)
+      cout<<" "<<setw(11)<<results.front().median / r.median;
+    cout<<"\n";
+  }
+  cout.flags(flags);
+  cout.precision(precision);
+}
+
+bool CSBENCHMARK::writeJson(const char* path)
+{
+  ofstream out(path ? path : "");
+  if (!out.is_open())
+  {
+    cout<<"cannot write benchmark file !\n";
+    return false;
+  }
+  static const char* filters[] = {"none", "mad", "iqr"};
+  out<<fixed<<setprecision(3);
+  out<<"{\n  \"unit\": \"ns\",\n  \"settings\": {\"warmup\": "<<warmup<<", \"repetitions\": "<<repetitions
+     <<", \"outlierFilter\": \""<<filters[outlierFilter]<<"\", \"outlierThreshold\": "<<outlierThreshold
+     <<", \"minSampleTime\": "<<minSampleTime<<"},\n  \"benchmarks\": [";
+  for(size_t i=0; i<results.size(); i++)
+  {
+    const CSBENCH_RESULT& r = results[i];
+    out<<(i ? ",\n" : "\n")<<"    {\"name\": ";
+    csParallelTask::writeJsonString(out, r.name);
+    out<<", \"warmup\": "<<r.warmup<<", \"repetitions\": "<<r.repetitions<<", \"batch\": "<<r.batch
+       <<", \"kept\": "<<r.kept<<", \"outliers\": "<<r.outliers
+       <<",\n     \"min\": "<<r.min<<", \"max\": "<<r.max<<", \"median\": "<<r.median<<", \"mean\": "<<r.mean
+       <<", \"p95\": "<<r.p95<<", \"p99\": "<<r.p99<<", \"stddev\": "<<r.stddev;
+    if (r.hasCounters)
+    {
+      out<<",\n     \"counters\": {";
+      bool first = true;
+      for(int k=0; k<CSPERF_COUNTER_NUMBER; k++)
+      {
+        if (!r.counters.available[k])
+          continue;
+        out<<(first ? "" : ", ")<<"\""<<COUNTER_KEYS[k]<<"\": "<<r.counters.value[k];
+        first = false;
+      }
+      out<<"}";
+    }
+    out<<",\n     \"samples\": [";
+    for(size_t k=0; k<r.samples.size(); k++)
+      out<<(k ? ", " : "")<<r.samples[k];
+    out<<"]}";
+  }
+  out<<"\n  ]\n}\n";
+  return out.good();
+}
+
+bool CSBENCHMARK::writeCsv(const char* path)
+{
+  ofstream out(path ? path : "");
+  if (!out.is_open())
+  {
+    cout<<"cannot write benchmark file !\n";
+    return false;
+  }
+  out<<"name,warmup,repetitions,batch,kept,outliers,min_ns,max_ns,median_ns,mean_ns,p95_ns,p99_ns,stddev_ns\n";
+  out<<fixed<<setprecision(3);
+  for(const CSBENCH_RESULT& r : results)
+  {
+    // Nom entre guillemets, guillemets doubles a l'interieur
+    out<<'"';
+    for(char c : r.name)
+      out<<(c == '"' ? "\"\"" : string(1, c));
+    out<<"\","<<r.warmup<<","<<r.repetitions<<","<<r.batch<<","<<r.kept<<","<<r.outliers<<","<<r.min<<","<<r.max<<","
+       <<r.median<<","<<r.mean<<","<<r.p95<<","<<r.p99<<","<<r.stddev<<"\n";
+  }
+  return out.good();
+}
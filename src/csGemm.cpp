@@ -0,0 +1,288 @@
+#include <iostream>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+#include "csGemm.h"
+#include "csAlgorithm.h"
+#include "csSimd.h"
+
+#if defined __x86_64__ || defined _M_X64 || defined __i386__ || defined _M_IX86
+  #define CSGEMM_X86
+  #include <immintrin.h>
+  #ifdef _MSC_VER
+    #define CSGEMM_TARGET_AVX2
+  #else
+    #define CSGEMM_TARGET_AVX2 __attribute__ ((target ("avx2,fma")))
+  #endif
+#endif
+
+// En dessous de ce nombre d'operations, le produit est calcule sur le thread appelant
+#define CSGEMM_SEQUENTIAL_FLOPS  (1 << 21)
+
+using namespace std;
+
+// Met a jour un bloc CSGEMM_MR x CSGEMM_NR de C : c = alpha*a*b + beta*c, a et b etant des panneaux empaquetes de longueur kc
+typedef void (*GEMM_KERNEL)(size_t kc, const double* a, const double* b, double* c, size_t ldc, double alpha, double beta);
+
+static void kernelScalar(size_t kc, const double* a, const double* b, double* c, size_t ldc, double alpha, double beta)
+{
+  double ab[CSGEMM_MR*CSGEMM_NR] = {0};
+  for(size_t k=0; k<kc; k++)
+  {
+    for(size_t i=0; i<CSGEMM_MR; i++)
+    {
+      double ai = a[i];
+      for(size_t j=0; j<CSGEMM_NR; j++)
+        ab[i*CSGEMM_NR + j] += ai*b[j];
+    }
+    a += CSGEMM_MR;
+    b += CSGEMM_NR;
+  }
+  for(size_t i=0; i<CSGEMM_MR; i++)
+  {
+    for(size_t j=0; j<CSGEMM_NR; j++)
+    {
+      double& cij = c[i*ldc + j];
+      cij = beta == 0.0 ? alpha*ab[i*CSGEMM_NR + j] : alpha*ab[i*CSGEMM_NR + j] + beta*cij;
+    }
+  }
+}
+
+#ifdef CSGEMM_X86
+// 6 lignes x 2 registres de 4 doubles : 12 accumulateurs, 2 registres pour B et 1 pour A sur les 16 registres AVX2
+#define CSGEMM_ROW_FMA(i) \
+  ai = _mm256_broadcast_sd(a + i); \
+  c##i##0 = _mm256_fmadd_pd(ai, b0, c##i##0); \
+  c##i##1 = _mm256_fmadd_pd(ai, b1, c##i##1);
+
+#define CSGEMM_ROW_STORE(i) \
+  c##i##0 = _mm256_mul_pd(va, c##i##0); \
+  c##i##1 = _mm256_mul_pd(va, c##i##1); \
+  if (beta != 0.0) \
+  { \
+    c##i##0 = _mm256_fmadd_pd(vb, _mm256_loadu_pd(c + i*ldc), c##i##0); \
+    c##i##1 = _mm256_fmadd_pd(vb, _mm256_loadu_pd(c + i*ldc + 4), c##i##1); \
+  } \
+  _mm256_storeu_pd(c + i*ldc, c##i##0); \
+  _mm256_storeu_pd(c + i*ldc + 4, c##i##1);
+
+CSGEMM_TARGET_AVX2 static void kernelAvx2(size_t kc, const double* a, const double* b, double* c, size_t ldc, double alpha, double beta)
+{
+  __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+  __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+  __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+  __m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+  __m256d c40 = _mm256_setzero_pd(), c41 = _mm256_setzero_pd();
+  __m256d c50 = _mm256_setzero_pd(), c51 = _mm256_setzero_pd();
+  __m256d ai, b0, b1;
+
+  for(size_t k=0; k<kc; k++)
+  {
+    b0 = _mm256_loadu_pd(b);
+    b1 = _mm256_loadu_pd(b + 4);
+    CSGEMM_ROW_FMA(0)
+    CSGEMM_ROW_FMA(1)
+    CSGEMM_ROW_FMA(2)
+    CSGEMM_ROW_FMA(3)
+    CSGEMM_ROW_FMA(4)
+    CSGEMM_ROW_FMA(5)
+    a += CSGEMM_MR;
+    b += CSGEMM_NR;
+  }
+
+  __m256d va = _mm256_set1_pd(alpha);
+  __m256d vb = _mm256_set1_pd(beta);
+  CSGEMM_ROW_STORE(0)
+  CSGEMM_ROW_STORE(1)
+  CSGEMM_ROW_STORE(2)
+  CSGEMM_ROW_STORE(3)
+  CSGEMM_ROW_STORE(4)
+  CSGEMM_ROW_STORE(5)
+}
+
+#endif
+
+static bool cpuHasAvx2Fma()
+{
+#ifdef CSGEMM_X86
+  return csParallelTask::getCpuSimdLevel() >= CSSIMD_AVX2;
+#else
+  return false;
+#endif
+}
+
+static atomic<int> gemmKernel(CSGEMM_KERNEL_AUTO);
+
+static GEMM_KERNEL selectKernel()
+{
+#ifdef CSGEMM_X86
+  if (csParallelTask::getGemmKernel() == CSGEMM_KERNEL_AVX2)
+    return kernelAvx2;
+#endif
+  return kernelScalar;
+}
+
+// Panneaux de CSGEMM_MR lignes de A, colonne par colonne ; les lignes manquantes du dernier panneau valent 0
+static void packA(size_t mc, size_t kc, const double* A, size_t lda, double* buf)
+{
+  for(size_t ir=0; ir<mc; ir+=CSGEMM_MR)
+  {
+    size_t mr = min((size_t)CSGEMM_MR, mc-ir);
+    for(size_t k=0; k<kc; k++)
+    {
+      for(size_t i=0; i<mr; i++)
+        buf[i] = A[(ir+i)*lda + k];
+      for(size_t i=mr; i<CSGEMM_MR; i++)
+        buf[i] = 0.0;
+      buf += CSGEMM_MR;
+    }
+  }
+}
+
+// Panneaux de CSGEMM_NR colonnes de B, ligne par ligne ; les colonnes manquantes du dernier panneau valent 0
+static void packB(size_t kc, size_t nc, const double* B, size_t ldb, double* buf)
+{
+  for(size_t jr=0; jr<nc; jr+=CSGEMM_NR)
+  {
+    size_t nr = min((size_t)CSGEMM_NR, nc-jr);
+    for(size_t k=0; k<kc; k++)
+    {
+      const double* row = B + k*ldb + jr;
+      for(size_t j=0; j<nr; j++)
+        buf[j] = row[j];
+      for(size_t j=nr; j<CSGEMM_NR; j++)
+        buf[j] = 0.0;
+      buf += CSGEMM_NR;
+    }
+  }
+}
+
+// Produit d'un bloc empaquete mc x kc de A par un bloc kc x nc de B ; les bords passent par un bloc temporaire
+static void macroKernel(GEMM_KERNEL kernel, size_t mc, size_t nc, size_t kc, double alpha, const double* Ap, const double* Bp, double beta, double* C, size_t ldc)
+{
+  double tmp[CSGEMM_MR*CSGEMM_NR];
+  for(size_t jr=0; jr<nc; jr+=CSGEMM_NR)
+  {
+    size_t nr = min((size_t)CSGEMM_NR, nc-jr);
+    for(size_t ir=0; ir<mc; ir+=CSGEMM_MR)
+    {
+      size_t mr = min((size_t)CSGEMM_MR, mc-ir);
+      double* c = C + ir*ldc + jr;
+      if (mr == CSGEMM_MR && nr == CSGEMM_NR)
+      {
+        kernel(kc, Ap + ir*kc, Bp + jr*kc, c, ldc, alpha, beta);
+        continue;
+      }
+      kernel(kc, Ap + ir*kc, Bp + jr*kc, tmp, CSGEMM_NR, alpha, 0.0);
+      for(size_t i=0; i<mr; i++)
+      {
+        for(size_t j=0; j<nr; j++)
+        {
+          double& cij = c[i*ldc + j];
+          cij = beta == 0.0 ? tmp[i*CSGEMM_NR + j] : tmp[i*CSGEMM_NR + j] + beta*cij;
+        }
+      }
+    }
+  }
+}
+
+void CS_PARALLEL_TASK_API csParallelTask::gemm(size_t M, size_t N, size_t K, double alpha, const double* A, size_t lda, const double* B, size_t ldb, double beta, double* C, size_t ldc)
+{
+  if (M == 0 || N == 0)
+    return;
+  if (lda < K || ldb < N || ldc < N)
+  {
+    cout<<"invalid leading dimension !\n";
+    return;
+  }
+  if (K == 0 || alpha == 0.0)
+  {
+    parallel_for(0, M, [&](size_t i)
+    {
+      for(size_t j=0; j<N; j++)
+        C[i*ldc + j] = beta == 0.0 ? 0.0 : beta*C[i*ldc + j];
+    }, 64);
+    return;
+  }
+
+  // Tuiles de CSGEMM_MC lignes ; on reduit leur largeur tant qu'il n'y a pas au moins deux tuiles par tache
+  size_t tileRows = CSGEMM_MC;
+  size_t tileCols = min((size_t)CSGEMM_NC, (N + CSGEMM_NR - 1)/CSGEMM_NR*CSGEMM_NR);
+  size_t nTasks = getThreadPool()->getWorkerNumber() + 1;
+  if (2.0*M*N*K < CSGEMM_SEQUENTIAL_FLOPS || nTasks == 1)
+  {
+    tileRows = M;
+    tileCols = N;
+  }
+  else
+  {
+    size_t rowTiles = (M + tileRows - 1)/tileRows;
+    while (rowTiles*((N + tileCols - 1)/tileCols) < 2*nTasks && tileCols > 4*CSGEMM_NR)
+      tileCols = (tileCols/2 + CSGEMM_NR - 1)/CSGEMM_NR*CSGEMM_NR;
+  }
+
+  size_t nTiles;
+  TILE_SHAPE tiles = makeMortonTileShape(M, N, tileRows, tileCols, &nTiles);
+  GEMM_KERNEL kernel = selectKernel();
+
+  parallel_for(0, nTiles, [&](size_t t)
+  {
+    // Tampons d'empaquetage propres a chaque thread, gardes d'un appel a l'autre
+    thread_local vector<double> bufA, bufB;
+    CSPARGS::TILE tile = tiles[t];
+    size_t tileN = min(tile.x.last - tile.x.first, (size_t)CSGEMM_NC);
+    bufA.resize(((size_t)CSGEMM_MC + CSGEMM_MR)*CSGEMM_KC);
+    bufB.resize((tileN + CSGEMM_NR)*CSGEMM_KC);
+
+    for(size_t jc=tile.x.first; jc<tile.x.last; jc+=CSGEMM_NC)
+    {
+      size_t nc = min((size_t)CSGEMM_NC, tile.x.last-jc);
+      for(size_t pc=0; pc<K; pc+=CSGEMM_KC)
+      {
+        size_t kc = min((size_t)CSGEMM_KC, K-pc);
+        double betaK = pc == 0 ? beta : 1.0;
+        packB(kc, nc, B + pc*ldb + jc, ldb, bufB.data());
+        for(size_t ic=tile.y.first; ic<tile.y.last; ic+=CSGEMM_MC)
+        {
+          size_t mc = min((size_t)CSGEMM_MC, tile.y.last-ic);
+          packA(mc, kc, A + ic*lda + pc, lda, bufA.data());
+          macroKernel(kernel, mc, nc, kc, alpha, bufA.data(), bufB.data(), betaK, C + ic*ldc + jc, ldc);
+        }
+      }
+    }
+  }, 1);
+
+  free(tiles);
+}
+
+void CS_PARALLEL_TASK_API csParallelTask::matrixMultiply(size_t M, size_t N, size_t K, const double* A, const double* B, double* C)
+{
+  gemm(M, N, K, 1.0, A, K, B, N, 0.0, C, N);
+}
+
+bool CS_PARALLEL_TASK_API csParallelTask::setGemmKernel(int kernel)
+{
+  if (kernel == CSGEMM_KERNEL_AVX2 && !cpuHasAvx2Fma())
+  {
+    cout<<"AVX2/FMA is not supported by this CPU !\n";
+    return false;
+  }
+  if (kernel != CSGEMM_KERNEL_AUTO && kernel != CSGEMM_KERNEL_SCALAR && kernel != CSGEMM_KERNEL_AVX2)
+  {
+    cout<<"invalid gemm kernel !\n";
+    return false;
+  }
+  gemmKernel = kernel;
+  return true;
+}
+
+int CS_PARALLEL_TASK_API csParallelTask::getGemmKernel()
+{
+  int kernel = gemmKernel;
+  if (kernel == CSGEMM_KERNEL_AUTO)
+  {
+    static const int best = cpuHasAvx2Fma() ? CSGEMM_KERNEL_AVX2 : CSGEMM_KERNEL_SCALAR;
+    kernel = best;
+  }
+  return kernel;
+}
@@ -0,0 +1,35 @@
+#ifndef CSJSON_INTERNAL_H_INCLUDED
+#define CSJSON_INTERNAL_H_INCLUDED
+
+#include <iomanip>
+#include <ostream>
+#include <string>
+
+// Ecriture JSON partagee par les modules qui produisent des fichiers (benchmarks, traces), hors API publique
+
+namespace csParallelTask
+{
+
+/**
+ * @brief Writes @p s as a quoted JSON string: quotes and backslashes are escaped, control characters become \\uXXXX.
+ * @param out Output stream.
+ * @param s String to write.
+ */
+inline void writeJsonString(std::ostream& out, const std::string& s)
+{
+  out<<'"';
+  for(unsigned char c : s)
+  {
+    if (c == '"' || c == '\\')
+      out<<'\\'<<c;
+    else if (c < 0x20)
+      out<<"\\u"<<std::hex<<std::setw(4)<<std::setfill('0')<<(int)c<<std::dec<<std::setfill(' ');
+    else
+      out<<c;
+  }
+  out<<'"';
+}
+
+}
+
+#endif // CSJSON_INTERNAL_H_INCLUDED
@@ -1,17 +1,93 @@
 
 #include <iostream>
+#include <algorithm>
 #include <functional>
 #include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <set>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <time.h>
+#endif
 #include "csPargs.h"
 #include "csParallel.h"
+#include "csParallelInternal.h"
+#include "csTuner.h"
+#include "csTraceInternal.h"
 
 
 using namespace std;
 
-vector<void(*)(CSPARGS)> BLOCK_FUNC;
-vector<vector<CSPARGS>> BLOCK_ARGS;
-vector<string> THREAD_NAME;
-vector<size_t> THREAD_GLOBAL_SIZE;
+// Descripteur de bloc : chacun sur ses propres lignes de cache, ceux d'une fonction sont contigus
+typedef struct alignas(64)
+{
+  CSPARGS args;
+}BLOCK_DESC;
+
+// Entree du registre : les workers lisent les descripteurs sur place, sans copie ni indirection par indice
+typedef struct
+{
+  void(*func)(CSPARGS);
+  CSCALLABLE callable;
+  size_t nBlocks;
+  BLOCK_DESC* blocks;
+  void** argTable;
+  size_t workSize;
+  int schedule;
+  size_t chunkSize;
+  CSTASK_FUTURE background;
+  string name;
+  uint32_t traceId;
+  int affinity;
+  vector<size_t> cpuList;
+  vector<size_t> blockCpu;
+  vector<size_t> blockWorker;
+  bool adaptive;
+  double tolerance;
+  bool timing;
+  chrono::steady_clock::time_point launchTime;
+  vector<CSBLOCK_TIMING> blockTiming;
+}TASK_ENTRY;
+
+// Emplacement du registre : l'identifiant d'une fonction porte l'indice de l'emplacement et sa generation,
+// incrementee a chaque desenregistrement pour detecter les identifiants perimes. Un emplacement dont la generation
+// reviendrait a 0 est retire : un ancien identifiant ne redevient jamais valide
+typedef struct
+{
+  TASK_ENTRY* task;
+  size_t generation;
+}TASK_SLOT;
+
+static const size_t SLOT_BITS = 16;
+static const size_t SLOT_MASK = ((size_t)1 << SLOT_BITS) - 1;
+static const size_t GENERATION_MASK = ((size_t)1 << 15) - 1;
+
+vector<TASK_SLOT> TASKS;
+vector<size_t> FREE_SLOTS;
+// Fonctions de meme nom ou de meme pointeur, dans l'ordre d'enregistrement.
+// Les cles pointent sur le nom stocke dans la premiere entree : pas d'allocation a la recherche
+unordered_map<string_view, vector<size_t>> TASK_BY_NAME;
+unordered_map<uintptr_t, vector<size_t>> TASK_BY_FUNC;
+
+static TASK_ENTRY* findTask(size_t idf)
+{
+  size_t slot = idf & SLOT_MASK;
+  if (idf == CSTASK_INVALID_ID || slot >= TASKS.size() || !TASKS[slot].task || TASKS[slot].generation != (idf >> SLOT_BITS))
+  {
+    cout<<"invalid function id !\n";
+    return 0;
+  }
+  return TASKS[slot].task;
+}
 
 using namespace csParallelTask;
 
@@ -25,112 +101,320 @@ size_t CS_PARALLEL_TASK_API csParallelTask::getHardwareConcurrency()
 
 size_t CS_PARALLEL_TASK_API csParallelTask::getSafeThreadNumber(size_t n)
 {
-  return std::min(n,getHardwareConcurrency());
+  return std::min(n,getAvailableConcurrency());
+}
+
+CS_PARALLEL_TASK_API CSTHREAD_POOL* csParallelTask::getThreadPool()
+{
+  // Initialisation d'une statique locale : garantie une seule fois, meme si plusieurs threads appellent en meme temps.
+  // Le pool n'est jamais detruit : joindre des threads pendant le dechargement de la DLL peut bloquer
+  static CSTHREAD_POOL* pool = new CSTHREAD_POOL(getAvailableConcurrency());
+  return pool;
+}
+
+// Worker qui execute chaque bloc : celui qui est lie au CPU choisi pour le bloc, sinon un worker fixe
+static void updatePlacement(TASK_ENTRY* t)
+{
+  CSTHREAD_POOL* pool = getThreadPool();
+  size_t nWorkers = std::max((size_t)1, pool->getWorkerNumber());
+  t->blockWorker.clear();
+  for(size_t i=0; i<t->blockCpu.size(); i++)
+  {
+    size_t w = pool->getWorkerOnCpu(t->blockCpu[i]);
+    t->blockWorker.push_back(w != CSTHREAD_POOL::NO_CPU ? w : i % nWorkers);
+  }
+}
+
+static void updatePlacements()
+{
+  for(TASK_SLOT& slot : TASKS)
+  {
+    if (slot.task && slot.task->affinity != CSAFFINITY_NONE)
+      updatePlacement(slot.task);
+  }
+}
+
+void CS_PARALLEL_TASK_API csParallelTask::setThreadPoolSize(size_t nWorkers)
+{
+  if (nWorkers == 0)
+  {
+    cout<<"invalid worker number !\n";
+    return;
+  }
+  getThreadPool()->start(nWorkers);
+  updatePlacements();
 }
 
 CSPARGS CS_PARALLEL_TASK_API csParallelTask::getArgs(size_t idf, size_t ida)
 {
-  return BLOCK_ARGS[idf][ida];
+  TASK_ENTRY* t = findTask(idf);
+  if (!t || ida >= t->nBlocks)
+    return CSPARGS();
+  return t->blocks[ida].args;
 }
 
 vector<CSPARGS> CS_PARALLEL_TASK_API csParallelTask::getArgs(size_t idf)
 {
-  return BLOCK_ARGS[idf];
+  TASK_ENTRY* t = findTask(idf);
+  vector<CSPARGS> pargs;
+  if (!t)
+    return pargs;
+  for(size_t i=0; i<t->nBlocks; i++)
+  {
+    pargs.push_back(t->blocks[i].args);
+  }
+  return pargs;
+}
+
+// Bande i sur nBands d'un intervalle de taille n
+static CSPARGS::BOUNDS band(size_t n, size_t nBands, size_t i)
+{
+  return {i*n/nBands, (i+1)*n/nBands};
 }
 
 BUFFER_SHAPE CS_PARALLEL_TASK_API csParallelTask::makeRegularBufferShape(size_t workSize, size_t nBlocks)
 {
-  BUFFER_SHAPE  bp;
+  BUFFER_SHAPE  bp = 0;
   if (nBlocks>0)
   {
+    // Le reste de la division est reparti : les tailles des blocs different d'au plus un element
     bp = _csAlloc<CSPARGS::BOUNDS>(nBlocks);
-    size_t len = workSize/nBlocks;
-
-    for(int i=0; i<nBlocks; i++)
+    for(size_t i=0; i<nBlocks; i++)
     {
-      bp[i] = {i*len, (i+1)*len};
+      bp[i] = band(workSize, nBlocks, i);
     }
-    bp[nBlocks-1].last = workSize;
   }
   else
     cout<<"invalid block size !\n";
   return bp;
 }
 
-void CS_PARALLEL_TASK_API csParallelTask::setArgs(size_t idf, BUFFER_SHAPE shape, CSPARGS funcArgs)
+BUFFER_SHAPE CS_PARALLEL_TASK_API csParallelTask::makePrefixCostBufferShape(size_t workSize, size_t nBlocks, const double* prefixCost)
 {
-  size_t nBlocks = BLOCK_ARGS[idf].size();
-  if (nBlocks > 0)
+  if (nBlocks == 0 || (workSize > 0 && !prefixCost))
   {
-    vector<CSPARGS> *arg = &BLOCK_ARGS[idf];
+    cout<<"invalid block size !\n";
+    return 0;
+  }
+  BUFFER_SHAPE bp = _csAlloc<CSPARGS::BOUNDS>(nBlocks);
+  double total = workSize > 0 ? prefixCost[workSize-1] : 0.0;
+  if (total <= 0.0)
+  {
+    for(size_t i=0; i<nBlocks; i++)
+      bp[i] = band(workSize, nBlocks, i);
+    return bp;
+  }
 
-    size_t nbArgs = funcArgs.getArgNumber();
+  // Limite k : premier e tel que le cout de [0, e) atteint k*total/nBlocks, ou e-1 si ce cout est plus proche de la cible
+  size_t first = 0;
+  for(size_t k=1; k<nBlocks; k++)
+  {
+    double target = total*k/nBlocks;
+    size_t idx = lower_bound(prefixCost + first, prefixCost + workSize, target) - prefixCost;
+    size_t e = min(idx + 1, workSize);
+    if (idx < workSize && idx > first && target - prefixCost[idx-1] < prefixCost[idx] - target)
+      e = idx;
+    bp[k-1] = {first, e};
+    first = e;
+  }
+  bp[nBlocks-1] = {first, workSize};
+  return bp;
+}
 
-    for(size_t i=0; i<nBlocks; i++)
-    {
-      (*arg)[i].clear();
-      (*arg)[i].setArgNumber(nbArgs);
-      (*arg)[i].setBlockId(i);
-      (*arg)[i].setBounds(shape[i]);
-      (*arg)[i].setBlocksNumber(nBlocks);
+TILE_SHAPE CS_PARALLEL_TASK_API csParallelTask::makeRowBandShape(size_t rows, size_t cols, size_t nBands)
+{
+  if (nBands == 0)
+  {
+    cout<<"invalid block size !\n";
+    return 0;
+  }
+  TILE_SHAPE shape = _csAlloc<CSPARGS::TILE>(nBands);
+  for(size_t i=0; i<nBands; i++)
+  {
+    shape[i] = {{0, cols}, band(rows, nBands, i), {0, 1}};
+  }
+  return shape;
+}
 
-      for(size_t j=0; j<nbArgs; j++)
-      {
-        (*arg)[i].setArg(j,funcArgs.getArg(j));
-      }
+TILE_SHAPE CS_PARALLEL_TASK_API csParallelTask::makeColumnBandShape(size_t rows, size_t cols, size_t nBands)
+{
+  if (nBands == 0)
+  {
+    cout<<"invalid block size !\n";
+    return 0;
+  }
+  TILE_SHAPE shape = _csAlloc<CSPARGS::TILE>(nBands);
+  for(size_t i=0; i<nBands; i++)
+  {
+    shape[i] = {band(cols, nBands, i), {0, rows}, {0, 1}};
+  }
+  return shape;
+}
+
+// Entrelace les bits des coordonnees de tuile : les tuiles voisines dans l'ordre de Morton sont voisines dans l'espace
+static uint64_t mortonCode(size_t x, size_t y, size_t z, size_t nDims)
+{
+  uint64_t code = 0;
+  for(size_t b=0; b*nDims<64; b++)
+  {
+    code |= (uint64_t)((x >> b) & 1) << (b*nDims);
+    code |= (uint64_t)((y >> b) & 1) << (b*nDims + 1);
+    if (nDims == 3 && b*nDims + 2 < 64)
+      code |= (uint64_t)((z >> b) & 1) << (b*nDims + 2);
+  }
+  return code;
+}
+
+TILE_SHAPE CS_PARALLEL_TASK_API csParallelTask::makeTileShape3D(size_t slices, size_t rows, size_t cols, size_t tileSlices, size_t tileRows, size_t tileCols, size_t* nTiles, bool morton)
+{
+  *nTiles = 0;
+  if (slices == 0 || rows == 0 || cols == 0 || tileSlices == 0 || tileRows == 0 || tileCols == 0)
+  {
+    cout<<"invalid block size !\n";
+    return 0;
+  }
+  size_t gz = (slices + tileSlices - 1)/tileSlices;
+  size_t gy = (rows + tileRows - 1)/tileRows;
+  size_t gx = (cols + tileCols - 1)/tileCols;
+  size_t n = gx*gy*gz;
+
+  // Ordre des tuiles : ligne par ligne, ou selon la courbe de Morton (les grilles non carrees sont triees par code)
+  vector<pair<uint64_t, size_t>> order(n);
+  for(size_t i=0; i<n; i++)
+  {
+    size_t x = i % gx, y = (i / gx) % gy, z = i / (gx*gy);
+    order[i] = {morton ? mortonCode(x, y, z, slices > 1 ? 3 : 2) : i, i};
+  }
+  if (morton)
+    std::sort(order.begin(), order.end());
+
+  TILE_SHAPE shape = _csAlloc<CSPARGS::TILE>(n);
+  for(size_t k=0; k<n; k++)
+  {
+    size_t i = order[k].second;
+    size_t x = i % gx, y = (i / gx) % gy, z = i / (gx*gy);
+    shape[k].x = {x*tileCols, std::min(cols, (x+1)*tileCols)};
+    shape[k].y = {y*tileRows, std::min(rows, (y+1)*tileRows)};
+    shape[k].z = {z*tileSlices, std::min(slices, (z+1)*tileSlices)};
+  }
+  *nTiles = n;
+  return shape;
+}
+
+TILE_SHAPE CS_PARALLEL_TASK_API csParallelTask::makeTileShape(size_t rows, size_t cols, size_t tileRows, size_t tileCols, size_t* nTiles)
+{
+  return makeTileShape3D(1, rows, cols, 1, tileRows, tileCols, nTiles, false);
+}
+
+TILE_SHAPE CS_PARALLEL_TASK_API csParallelTask::makeMortonTileShape(size_t rows, size_t cols, size_t tileRows, size_t tileCols, size_t* nTiles)
+{
+  return makeTileShape3D(1, rows, cols, 1, tileRows, tileCols, nTiles, true);
+}
+
+// Les arguments de tous les blocs sont ranges dans une seule table contigue
+static void setBlockArgs(TASK_ENTRY* t, BUFFER_SHAPE shape, CSPARGS& funcArgs)
+{
+  size_t nbArgs = funcArgs.getArgNumber();
+  size_t stride = nbArgs + 2;
+  void** table = (void**)malloc(t->nBlocks*stride*sizeof(void*));
+
+  for(size_t i=0; i<t->nBlocks; i++)
+  {
+    CSPARGS* arg = &t->blocks[i].args;
+    arg->setArgStorage(table + i*stride, nbArgs);
+    arg->setBlockId(i);
+    arg->setBounds(shape[i]);
+    arg->setTile({shape[i], {0,1}, {0,1}});
+    arg->setBlocksNumber(t->nBlocks);
+
+    for(size_t j=0; j<nbArgs; j++)
+    {
+      arg->setArg(j,funcArgs.getArg(j));
     }
   }
+
+  free(t->argTable);
+  t->argTable = table;
+}
+
+void CS_PARALLEL_TASK_API csParallelTask::setArgs(size_t idf, BUFFER_SHAPE shape, CSPARGS funcArgs)
+{
+  TASK_ENTRY* t = findTask(idf);
+  if (t && t->nBlocks > 0)
+    setBlockArgs(t, shape, funcArgs);
 }
 
 void CS_PARALLEL_TASK_API csParallelTask::setArgsRegular(size_t idf, size_t workSize, CSPARGS funcArgs)
 {
-  size_t nBlocks = BLOCK_ARGS[idf].size();
-  BUFFER_SHAPE shape = makeRegularBufferShape(workSize, nBlocks);
+  TASK_ENTRY* t = findTask(idf);
+  if (!t)
+    return;
+  BUFFER_SHAPE shape = makeRegularBufferShape(workSize, t->nBlocks);
   setArgs(idf, shape, funcArgs);
   free(shape);
 }
 
-size_t CS_PARALLEL_TASK_API csParallelTask::registerFunction(size_t _nBlocks, size_t workSize, BUFFER_SHAPE shape, const char* fName, void(*Function)(CSPARGS), CSPARGS funcArgs)
+// Enregistrement avec un nombre de blocs deja valide
+static size_t registerEntry(size_t nBlocks, size_t workSize, BUFFER_SHAPE shape, const char* fName, void(*Function)(CSPARGS), CSPARGS funcArgs)
 {
-  size_t nBlocks = getSafeThreadNumber(_nBlocks);
-  size_t k = BLOCK_FUNC.size();
+  size_t k = CSTASK_INVALID_ID;
   if (nBlocks > 0)
   {
-    vector<CSPARGS> pargs;
-    CSPARGS arg[nBlocks];
+    size_t slot;
+    if (!FREE_SLOTS.empty())
+    {
+      slot = FREE_SLOTS.back();
+      FREE_SLOTS.pop_back();
+    }
+    else if (TASKS.size() <= SLOT_MASK)
+    {
+      slot = TASKS.size();
+      TASKS.push_back({0, 0});
+    }
+    else
+    {
+      cout<<"too many registered functions !\n";
+      return k;
+    }
+    k = (TASKS[slot].generation << SLOT_BITS) | slot;
+
+    TASK_ENTRY* t = new TASK_ENTRY;
+    t->func = Function;
+    t->callable = {0, 0, 0};
+    t->nBlocks = nBlocks;
+    t->blocks = new BLOCK_DESC[nBlocks];
+    t->argTable = 0;
+    t->workSize = workSize;
+    t->schedule = CSSCHEDULE_STATIC;
+    t->chunkSize = 0;
+    t->affinity = CSAFFINITY_NONE;
+    t->adaptive = false;
+    t->tolerance = CSADAPTIVE_TOLERANCE;
+    t->timing = false;
 
-    size_t nbArgs = funcArgs.getArgNumber();
+    setBlockArgs(t, shape, funcArgs);
     for(size_t i=0; i<nBlocks; i++)
     {
-      arg[i].setArgNumber(nbArgs);
-      arg[i].setBlockId(i);
-      arg[i].setBounds(shape[i]);
-      arg[i].setBlocksNumber(nBlocks);
-      arg[i].setWorkSize(workSize);
-      arg[i].setDelay(1);
-
-      for(size_t j=0; j<nbArgs; j++)
-      {
-        arg[i].setArg(j,funcArgs.getArg(j));
-      }
-
-      pargs.push_back(arg[i]);
+      t->blocks[i].args.setWorkSize(workSize);
+      t->blocks[i].args.setDelay(1);
     }
 
-    BLOCK_FUNC.push_back(Function);
-    BLOCK_ARGS.push_back(pargs);
-    THREAD_GLOBAL_SIZE.push_back(workSize);
-
     if(!(char*)fName)
     {
       char str[100] = {0};
-      sprintf(str,"%zu", THREAD_NAME.size());
-      THREAD_NAME.push_back(str);
+      sprintf(str,"%zu", k);
+      t->name = str;
     }
     else
     {
-      THREAD_NAME.push_back((char*)fName);
+      t->name = fName;
     }
+    t->traceId = traceName(t->name.c_str());
+    TASKS[slot].task = t;
+    // En cas de doublon, le nom et le pointeur designent la premiere fonction enregistree encore presente
+    TASK_BY_NAME[string_view(t->name)].push_back(k);
+    if (Function)
+      TASK_BY_FUNC[(uintptr_t)Function].push_back(k);
     }
     else
       cout<<"invalid block size !\n";
@@ -138,6 +422,62 @@ size_t CS_PARALLEL_TASK_API csParallelTask::registerFunction(size_t _nBlocks, si
     return k;
 }
 
+size_t CS_PARALLEL_TASK_API csParallelTask::registerFunction(size_t nBlocks, size_t workSize, BUFFER_SHAPE shape, const char* fName, void(*Function)(CSPARGS), CSPARGS funcArgs)
+{
+  size_t k = registerEntry(getSafeThreadNumber(nBlocks), workSize, shape, fName, Function, funcArgs);
+  // Profil de reglage (CSPARALLEL_TUNE_PROFILE ou loadTuningProfile) : jamais plus de blocs, jamais un autre decoupage
+  if (k != CSTASK_INVALID_ID)
+    applyTuningProfile(k);
+  return k;
+}
+
+size_t CS_PARALLEL_TASK_API csParallelTask::registerFunctionTiled(TILE_SHAPE shape, size_t nTiles, const char* fName, void(*Function)(CSPARGS), CSPARGS funcArgs)
+{
+  if (!shape || nTiles == 0)
+  {
+    cout<<"invalid block size !\n";
+    return CSTASK_INVALID_ID;
+  }
+
+  // Une tuile par bloc, sans limite au nombre de threads : le pool repartit les tuiles sur les workers
+  BUFFER_SHAPE rows = _csAlloc<CSPARGS::BOUNDS>(nTiles);
+  size_t workSize = 0;
+  for(size_t i=0; i<nTiles; i++)
+  {
+    rows[i] = shape[i].y;
+    workSize += (shape[i].x.last - shape[i].x.first)*(shape[i].y.last - shape[i].y.first)*(shape[i].z.last - shape[i].z.first);
+  }
+  size_t k = registerEntry(nTiles, workSize, rows, fName, Function, funcArgs);
+  free(rows);
+  // Le profil s'applique une fois les tuiles posees : seul le mode d'ordonnancement change
+  if (k != CSTASK_INVALID_ID)
+  {
+    setTileShape(k, shape);
+    applyTuningProfile(k);
+  }
+  return k;
+}
+
+size_t CS_PARALLEL_TASK_API csParallelTask::registerCallableTiled(TILE_SHAPE shape, size_t nTiles, const char* fName, CSCALLABLE callable)
+{
+  size_t k = registerFunctionTiled(shape, nTiles, fName, 0, CSPARGS(0));
+  if (k != CSTASK_INVALID_ID)
+    TASKS[k & SLOT_MASK].task->callable = callable;
+  else
+    callable.destroy(callable.callable);
+  return k;
+}
+
+size_t CS_PARALLEL_TASK_API csParallelTask::registerCallable(size_t nBlocks, size_t workSize, BUFFER_SHAPE shape, const char* fName, CSCALLABLE callable)
+{
+  size_t k = registerFunction(nBlocks, workSize, shape, fName, 0, CSPARGS(0));
+  if (k != CSTASK_INVALID_ID)
+    TASKS[k & SLOT_MASK].task->callable = callable;
+  else
+    callable.destroy(callable.callable);
+  return k;
+}
+
 size_t CS_PARALLEL_TASK_API csParallelTask::registerFunctionEx(size_t nBlocks, size_t workSize, BUFFER_SHAPE shape, const char* fName, void(*Function)(CSPARGS), size_t nbArgs,...)
 {
   va_list adArgs ;
@@ -169,7 +509,7 @@ size_t CS_PARALLEL_TASK_API csParallelTask::registerFunctionRegularEx(size_t nBl
   }
   va_end(adArgs);
 
-  BUFFER_SHAPE shape = makeRegularBufferShape(workSize, nBlocks);
+  BUFFER_SHAPE shape = makeRegularBufferShape(workSize, getSafeThreadNumber(nBlocks));
   CSPARGS funcArgs(nbArgs);
   funcArgs.regArgs2(Args,nbArgs);
 
@@ -178,99 +518,838 @@ size_t CS_PARALLEL_TASK_API csParallelTask::registerFunctionRegularEx(size_t nBl
   return idf;
 }
 
-void CS_PARALLEL_TASK_API csParallelTask::unregisterFunction(size_t idf)
+static void releaseTask(TASK_ENTRY* t)
 {
-  if (idf >= BLOCK_FUNC.size())
+  // Les blocs lances en arriere-plan utilisent encore les arguments
+  t->background.wait();
+
+  for(size_t i = 0; i < t->nBlocks; i++)
   {
-    cout<<"invalid function id !\n";
+    t->blocks[i].args.clear();
+  }
+  if (t->callable.destroy)
+    t->callable.destroy(t->callable.callable);
+
+  delete[] t->blocks;
+  free(t->argTable);
+  delete t;
+}
+
+// Retire l'identifiant de la liste de son nom. La cle peut pointer sur le nom de cette entree :
+// elle est refaite sur le nom de la fonction suivante
+static void eraseName(TASK_ENTRY* t, size_t idf)
+{
+  auto byName = TASK_BY_NAME.find(string_view(t->name));
+  if (byName == TASK_BY_NAME.end())
     return;
+  vector<size_t> ids = std::move(byName->second);
+  TASK_BY_NAME.erase(byName);
+  ids.erase(std::remove(ids.begin(), ids.end(), idf), ids.end());
+  if (!ids.empty())
+    TASK_BY_NAME.emplace(string_view(TASKS[ids.front() & SLOT_MASK].task->name), std::move(ids));
+}
+
+static void eraseFunc(TASK_ENTRY* t, size_t idf)
+{
+  auto byFunc = TASK_BY_FUNC.find((uintptr_t)t->func);
+  if (byFunc == TASK_BY_FUNC.end())
+    return;
+  vector<size_t>& ids = byFunc->second;
+  ids.erase(std::remove(ids.begin(), ids.end(), idf), ids.end());
+  if (ids.empty())
+    TASK_BY_FUNC.erase(byFunc);
+}
+
+// Libere l'emplacement sans deplacer les autres fonctions : leurs identifiants restent valides
+static void releaseSlot(size_t slot)
+{
+  TASK_ENTRY* t = TASKS[slot].task;
+  size_t idf = (TASKS[slot].generation << SLOT_BITS) | slot;
+
+  eraseName(t, idf);
+  if (t->func)
+    eraseFunc(t, idf);
+
+  releaseTask(t);
+  TASKS[slot].task = 0;
+  TASKS[slot].generation++;
+  if (TASKS[slot].generation <= GENERATION_MASK)
+    FREE_SLOTS.push_back(slot);
+}
+
+void CS_PARALLEL_TASK_API csParallelTask::unregisterFunction(size_t idf)
+{
+  if (!findTask(idf))
+    return;
+
+  releaseSlot(idf & SLOT_MASK);
+}
+
+void CS_PARALLEL_TASK_API csParallelTask::unregisterAll()
+{
+  // Ordre decroissant : les prochains enregistrements reprennent les emplacements a partir de 0.
+  // Les generations ne sont pas remises a 0 : les identifiants d'avant restent invalides
+  for(size_t f = TASKS.size(); f-- > 0; )
+  {
+    if (TASKS[f].task)
+      releaseSlot(f);
+  }
+  FREE_SLOTS.clear();
+  for(size_t f = TASKS.size(); f-- > 0; )
+  {
+    if (TASKS[f].generation <= GENERATION_MASK)
+      FREE_SLOTS.push_back(f);
   }
+}
+
+bool CS_PARALLEL_TASK_API csParallelTask::isRegistered(size_t idf)
+{
+  size_t slot = idf & SLOT_MASK;
+  return idf != CSTASK_INVALID_ID && slot < TASKS.size() && TASKS[slot].task && TASKS[slot].generation == (idf >> SLOT_BITS);
+}
+
+// Temps CPU du thread appelant, en nanosecondes
+static double threadCpuTime()
+{
+#ifdef _WIN32
+  FILETIME creation, exitTime, kernel, user;
+  if (!GetThreadTimes(GetCurrentThread(), &creation, &exitTime, &kernel, &user))
+    return 0.0;
+  ULARGE_INTEGER k, u;
+  k.LowPart = kernel.dwLowDateTime;
+  k.HighPart = kernel.dwHighDateTime;
+  u.LowPart = user.dwLowDateTime;
+  u.HighPart = user.dwHighDateTime;
+  return (double)(k.QuadPart + u.QuadPart)*100.0;
+#else
+  timespec ts;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0)
+    return 0.0;
+  return ts.tv_sec*1e9 + ts.tv_nsec;
+#endif
+}
+
+// Debut et fin de la mesure d'un bloc : le temps CPU n'est lu que si le suivi par bloc est actif
+static void beginBlockTiming(TASK_ENTRY* t, CSBLOCK_TIMING& m)
+{
+  m.worker = CSTHREAD_POOL::getWorkerIndex();
+  m.cpuTime = t->timing ? threadCpuTime() : 0.0;
+  m.start = chrono::duration<double, nano>(chrono::steady_clock::now() - t->launchTime).count();
+}
+
+static void endBlockTiming(TASK_ENTRY* t, CSBLOCK_TIMING& m, size_t i, size_t chunks)
+{
+  m.end = chrono::duration<double, nano>(chrono::steady_clock::now() - t->launchTime).count();
+  m.block = i;
+  m.wallTime = m.end - m.start;
+  m.cpuTime = t->timing ? threadCpuTime() - m.cpuTime : 0.0;
+  m.chunks = chunks;
+}
 
-  // Libérer correctement les CSPARGS associés
-  size_t nBlocks = BLOCK_ARGS[idf].size();
-  for(size_t i = 0; i < nBlocks; i++)
+static void runBlock(void* ctx, size_t i)
+{
+  TASK_ENTRY* t = (TASK_ENTRY*)ctx;
+  CSPARGS& args = t->blocks[i].args;
+  bool timed = i < t->blockTiming.size();
+  bool traced = isTracing();
+  if (traced)
+    traceEvent('B', CSTRACE_BLOCK, t->traceId, i);
+  if (timed)
+    beginBlockTiming(t, t->blockTiming[i]);
+  if (t->callable.invoke)
   {
-    BLOCK_ARGS[idf][i].clear();
+    // Descripteur lu sur place : seul l'etat de nextChunk() est remis a zero
+    args.setChunkSource(0);
+    t->callable.invoke(t->callable.callable, args);
   }
+  else
+    t->func(args);
+  if (timed)
+    endBlockTiming(t, t->blockTiming[i], i, 1);
+  if (traced)
+    traceEvent('E', CSTRACE_BLOCK, t->traceId, i);
+}
+
+// File de morceaux d'un bloc : le proprietaire consomme par l'avant, les voleurs prennent la moitie arriere
+typedef struct alignas(64)
+{
+  std::atomic<bool> locked;
+  size_t first;
+  size_t last;
+}CHUNK_DEQUE;
 
-  BLOCK_FUNC.erase(BLOCK_FUNC.begin() + idf);
-  BLOCK_ARGS.erase(BLOCK_ARGS.begin() + idf);
-  THREAD_NAME.erase(THREAD_NAME.begin() + idf);
-  THREAD_GLOBAL_SIZE.erase(THREAD_GLOBAL_SIZE.begin() + idf);
+typedef struct
+{
+  TASK_ENTRY* task;
+  int schedule;
+  size_t nBlocks;
+  size_t chunkSize;
+  size_t workSize;
+  alignas(64) std::atomic<size_t> next;
+  alignas(64) std::atomic<size_t> running;
+  CHUNK_DEQUE* deques;
+}SCHEDULE_CONTEXT;
+
+static void lockDeque(CHUNK_DEQUE* d)
+{
+  while (d->locked.exchange(true, std::memory_order_acquire))
+    std::this_thread::yield();
 }
 
-void CS_PARALLEL_TASK_API csParallelTask::unregisterAll()
+static void unlockDeque(CHUNK_DEQUE* d)
+{
+  d->locked.store(false, std::memory_order_release);
+}
+
+static bool popChunk(CHUNK_DEQUE* d, size_t chunkSize, CSPARGS::BOUNDS& chunk)
 {
-  // Libérer tous les CSPARGS avant de vider les vecteurs
-  size_t nFuncs = BLOCK_ARGS.size();
-  for(size_t f = 0; f < nFuncs; f++)
+  lockDeque(d);
+  bool found = d->first < d->last;
+  if (found)
   {
-    size_t nBlocks = BLOCK_ARGS[f].size();
-    for(size_t i = 0; i < nBlocks; i++)
+    chunk.first = d->first;
+    chunk.last = std::min(d->first + chunkSize, d->last);
+    d->first = chunk.last;
+  }
+  unlockDeque(d);
+  return found;
+}
+
+static bool stealChunks(SCHEDULE_CONTEXT* sc, size_t thief)
+{
+  for(size_t k=1; k<sc->nBlocks; k++)
+  {
+    CHUNK_DEQUE* victim = &sc->deques[(thief + k) % sc->nBlocks];
+    lockDeque(victim);
+    size_t rest = victim->last - victim->first;
+    if (rest == 0)
     {
-      BLOCK_ARGS[f][i].clear();
+      unlockDeque(victim);
+      continue;
     }
+
+    // Vol de la moitie des elements restants (au moins un morceau)
+    size_t stolen = rest > sc->chunkSize ? std::max(sc->chunkSize, rest/2) : rest;
+    size_t first = victim->last - stolen;
+    size_t last = victim->last;
+    victim->last = first;
+    unlockDeque(victim);
+
+    CHUNK_DEQUE* own = &sc->deques[thief];
+    lockDeque(own);
+    own->first = first;
+    own->last = last;
+    unlockDeque(own);
+    if (isTracing())
+      traceEvent('i', CSTRACE_STEAL, sc->task->traceId, (thief + k) % sc->nBlocks);
+    return true;
   }
+  return false;
+}
 
-  BLOCK_FUNC.clear();
-  BLOCK_ARGS.clear();
-  THREAD_NAME.clear();
-  THREAD_GLOBAL_SIZE.clear();
+static bool claimStealing(void* ctx, size_t block, CSPARGS::BOUNDS& chunk)
+{
+  SCHEDULE_CONTEXT* sc = (SCHEDULE_CONTEXT*)ctx;
+  for(;;)
+  {
+    if (popChunk(&sc->deques[block], sc->chunkSize, chunk))
+      return true;
+    if (!stealChunks(sc, block))
+      return false;
+  }
 }
 
-void CS_PARALLEL_TASK_API csParallelTask::execute(int id)
+static bool claimDynamic(void* ctx, size_t, CSPARGS::BOUNDS& chunk)
 {
-  int nBlocks = BLOCK_ARGS[id].size();
+  SCHEDULE_CONTEXT* sc = (SCHEDULE_CONTEXT*)ctx;
+  size_t first = sc->next.fetch_add(sc->chunkSize, std::memory_order_relaxed);
+  if (first >= sc->workSize)
+    return false;
+
+  chunk.first = first;
+  chunk.last = std::min(first + sc->chunkSize, sc->workSize);
+  return true;
+}
 
-  thread v[nBlocks];
-  for (size_t n = 0; n < nBlocks; n++)
+static bool claimGuided(void* ctx, size_t, CSPARGS::BOUNDS& chunk)
+{
+  SCHEDULE_CONTEXT* sc = (SCHEDULE_CONTEXT*)ctx;
+  size_t first = sc->next.load(std::memory_order_relaxed);
+  size_t len;
+  do
   {
-    v[n] = thread(
-      [](int i,int k)
-      {
-         BLOCK_FUNC[k](BLOCK_ARGS[k][i]);
-      },
-      n,id);
+    if (first >= sc->workSize)
+      return false;
+    // Morceaux decroissants : une part du reste, jamais moins que le grain
+    len = std::max(sc->chunkSize, (sc->workSize - first)/sc->nBlocks);
   }
+  while (!sc->next.compare_exchange_weak(first, first + len, std::memory_order_relaxed));
+
+  chunk.first = first;
+  chunk.last = std::min(first + len, sc->workSize);
+  return true;
+}
 
-  for(int i = 0; i<nBlocks; i++)
+static void runScheduledBlock(void* ctx, size_t i)
+{
+  SCHEDULE_CONTEXT* sc = (SCHEDULE_CONTEXT*)ctx;
+  TASK_ENTRY* t = sc->task;
+  void(*func)(CSPARGS) = t->func;
+  CSCALLABLE callable = t->callable;
+  // Copie : les bornes changent a chaque morceau
+  CSPARGS args = t->blocks[i].args;
+  CSPARGS::CHUNK_SOURCE source;
+  CSPARGS::BOUNDS chunk;
+  size_t chunks = 0;
+  bool timed = i < t->blockTiming.size();
+  bool traced = isTracing();
+  if (traced)
+    traceEvent('B', CSTRACE_BLOCK, t->traceId, i);
+  if (timed)
+    beginBlockTiming(t, t->blockTiming[i]);
+
+  source.ctx = sc;
+  if (sc->schedule == CSSCHEDULE_WORK_STEALING)
+    source.claim = claimStealing;
+  else if (sc->schedule == CSSCHEDULE_GUIDED)
+    source.claim = claimGuided;
+  else
+    source.claim = claimDynamic;
+
+  // La fonction est rappelee tant qu'il reste des morceaux ; si elle les consomme elle-meme
+  // par nextChunk(), la boucle s'arrete au premier appel
+  while (source.claim(sc, i, chunk))
+  {
+    args.setBounds(chunk);
+    args.setChunkSource(&source);
+    if (callable.invoke)
+      callable.invoke(callable.callable, args);
+    else
+      func(args);
+    chunks++;
+  }
+  if (timed)
+    endBlockTiming(t, t->blockTiming[i], i, chunks);
+  if (traced)
+    traceEvent('E', CSTRACE_BLOCK, t->traceId, i);
+
+  if (sc->running.fetch_sub(1, std::memory_order_acq_rel) == 1)
   {
-      if(BLOCK_ARGS[id][i].EXEC_MODE == CSTHREAD_NORMAL_EXECUTION)
-        v[i].join();
-      else
-        v[i].detach();
+    delete[] sc->deques;
+    delete sc;
   }
 }
 
+static SCHEDULE_CONTEXT* makeScheduleContext(TASK_ENTRY* t)
+{
+  size_t nBlocks = t->nBlocks;
+  SCHEDULE_CONTEXT* sc = new SCHEDULE_CONTEXT;
+  sc->task = t;
+  sc->schedule = t->schedule;
+  sc->nBlocks = nBlocks;
+  sc->workSize = t->workSize;
+  sc->chunkSize = t->chunkSize;
+  if (sc->chunkSize == 0)
+    sc->chunkSize = std::max((size_t)1, sc->workSize/(nBlocks*16));
+  sc->next = 0;
+  sc->running = nBlocks;
+  sc->deques = 0;
 
-size_t CS_PARALLEL_TASK_API csParallelTask::getId(const char*funcName)
+  if (sc->schedule == CSSCHEDULE_WORK_STEALING)
+  {
+    sc->deques = new CHUNK_DEQUE[nBlocks];
+    for(size_t i=0; i<nBlocks; i++)
+    {
+      CSPARGS::BOUNDS b = t->blocks[i].args.getBounds();
+      sc->deques[i].locked = false;
+      sc->deques[i].first = b.first;
+      sc->deques[i].last = b.last;
+    }
+  }
+  return sc;
+}
+
+// Les blocs en mode normal sont attendus avant de rendre la main, sauf si async est vrai ;
+// les autres sont rattaches au futur retourne
+static CSTASK_FUTURE dispatch(TASK_ENTRY* t, CSTHREAD_POOL::TASK_FUNC func, void* ctx, bool async)
 {
-  size_t id = 0;
-  size_t n = THREAD_NAME.size();
-  for(size_t i=0; i<n; i++)
+  // Un appel imbrique depuis un worker passe aussi par le pool : le worker execute des blocs pendant qu'il attend
+  size_t nBlocks = t->nBlocks;
+  CSTHREAD_POOL* pool = getThreadPool();
+  bool placed = !t->blockWorker.empty();
+  if (async)
   {
-    if(strcmp(THREAD_NAME[i].c_str(),funcName)==0)
+    CSTHREAD_POOL::TASK_GROUP* background = CSTHREAD_POOL::createGroup(nBlocks);
+    if (placed)
     {
-      id = i;
-      break;
+      for(size_t i=0; i<nBlocks; i++)
+        pool->submitTo(t->blockWorker[i], i, func, ctx, background);
     }
+    else
+      pool->submit(0, nBlocks, func, ctx, background);
+    return CSTASK_FUTURE(pool, background);
+  }
+
+  size_t nBackground = 0;
+  for(size_t i=0; i<nBlocks; i++)
+  {
+    if(t->blocks[i].args.EXEC_MODE == CSTHREAD_BACKGROUND_EXECUTION)
+      nBackground++;
   }
-  return id;
+
+  if (nBackground == 0 && !placed)
+  {
+    pool->run(nBlocks, func, ctx);
+    return CSTASK_FUTURE();
+  }
+
+  // Blocs places : l'appelant n'en execute aucun, chacun reste sur son worker
+  CSTHREAD_POOL::TASK_GROUP* background = nBackground > 0 ? CSTHREAD_POOL::createGroup(nBackground) : 0;
+  CSTHREAD_POOL::TASK_GROUP group;
+  group.pending = nBlocks - nBackground;
+  group.refs = 0;
+  for(size_t i=0; i<nBlocks; i++)
+  {
+    CSTHREAD_POOL::TASK_GROUP* g = t->blocks[i].args.EXEC_MODE == CSTHREAD_NORMAL_EXECUTION ? &group : background;
+    if (placed)
+      pool->submitTo(t->blockWorker[i], i, func, ctx, g);
+    else
+      pool->submit(i, i+1, func, ctx, g);
+  }
+  if (nBackground < nBlocks)
+    pool->wait(&group);
+  return background ? CSTASK_FUTURE(pool, background) : CSTASK_FUTURE();
 }
 
-size_t CS_PARALLEL_TASK_API csParallelTask::getId(void(*f)(CSPARGS))
+static void prepareTaskBlocks(TASK_ENTRY* t, CSTHREAD_POOL::TASK_FUNC* func, void** ctx)
 {
-  size_t id = 0;
-  size_t n = THREAD_NAME.size();
+  // Origine des instants mesures par bloc : le lancement, pour inclure la latence de distribution
+  if (!t->blockTiming.empty())
+    t->launchTime = chrono::steady_clock::now();
+  if (t->schedule == CSSCHEDULE_STATIC)
+  {
+    *func = runBlock;
+    *ctx = t;
+  }
+  else
+  {
+    *func = runScheduledBlock;
+    *ctx = makeScheduleContext(t);
+  }
+}
+
+void csParallelTask::prepareBlocks(size_t id, CSTHREAD_POOL::TASK_FUNC* func, void** ctx)
+{
+  TASK_ENTRY* t = TASKS[id & SLOT_MASK].task;
+  if (isTracing())
+    traceEvent('i', CSTRACE_LAUNCH, t->traceId, t->nBlocks);
+  prepareTaskBlocks(t, func, ctx);
+}
+
+static CSTASK_FUTURE launch(TASK_ENTRY* t, bool async)
+{
+  CSTHREAD_POOL::TASK_FUNC func;
+  void* ctx;
+  prepareTaskBlocks(t, &func, &ctx);
+  return dispatch(t, func, ctx, async);
+}
+
+// Un enregistrement par bloc tant que la forme adaptative ou le suivi par bloc est actif
+static void resetBlockTiming(TASK_ENTRY* t)
+{
+  CSBLOCK_TIMING zero = {0, CSTHREAD_POOL::NO_WORKER, 0.0, 0.0, 0.0, 0.0, 0};
+  t->blockTiming.assign(t->adaptive || t->timing ? t->nBlocks : 0, zero);
+}
+
+// Nouvelle forme a cout mesure egal : le cout par element est suppose uniforme dans chaque bloc,
+// la frontiere k est placee la ou le cout cumule atteint k*total/nBlocks
+static void adaptShape(TASK_ENTRY* t)
+{
+  size_t n = t->nBlocks;
+  vector<double> time(n);
+  double total = 0.0, slowest = 0.0;
   for(size_t i=0; i<n; i++)
   {
-    if(f == BLOCK_FUNC[i])
+    time[i] = t->blockTiming[i].wallTime;
+    total += time[i];
+    slowest = max(slowest, time[i]);
+  }
+  if (n < 2 || total <= 0.0 || slowest*n <= total*t->tolerance)
+    return;
+
+  vector<CSPARGS::BOUNDS> old(n);
+  for(size_t i=0; i<n; i++)
+  {
+    CSPARGS& args = t->blocks[i].args;
+    CSPARGS::TILE tile = args.getTile();
+    old[i] = args.getBounds();
+    // Seules les formes 1D contigues sont redecoupees
+    if (tile.x.first != old[i].first || tile.x.last != old[i].last || tile.y.first != 0 || tile.y.last != 1)
+      return;
+    if (i > 0 && old[i].first != old[i-1].last)
+      return;
+  }
+
+  size_t block = 0;
+  double before = 0.0;
+  size_t first = old[0].first;
+  for(size_t k=1; k<n; k++)
+  {
+    double target = total*k/n;
+    while (block < n-1 && before + time[block] < target)
     {
-      id = i;
-      break;
+      before += time[block];
+      block++;
     }
+    size_t len = old[block].last - old[block].first;
+    double frac = time[block] > 0.0 ? min(1.0, (target - before)/time[block]) : 0.0;
+    size_t cut = max(first, old[block].first + (size_t)(frac*len + 0.5));
+    t->blocks[k-1].args.setBounds({first, cut});
+    t->blocks[k-1].args.setTile({{first, cut}, {0,1}, {0,1}});
+    first = cut;
+  }
+  t->blocks[n-1].args.setBounds({first, old[n-1].last});
+  t->blocks[n-1].args.setTile({{first, old[n-1].last}, {0,1}, {0,1}});
+}
+
+void CS_PARALLEL_TASK_API csParallelTask::execute(int id)
+{
+  TASK_ENTRY* t = findTask((size_t)id);
+  if (!t)
+    return;
+  bool traced = isTracing();
+  if (traced)
+    traceEvent('B', CSTRACE_EXECUTE, t->traceId, t->nBlocks);
+  CSTASK_FUTURE background = launch(t, false);
+  if (background.isValid())
+    t->background = background;
+  else if (t->adaptive && t->schedule == CSSCHEDULE_STATIC)
+    adaptShape(t);
+  if (traced)
+    traceEvent('E', CSTRACE_EXECUTE, t->traceId, t->nBlocks);
+}
+
+CSTASK_FUTURE CS_PARALLEL_TASK_API csParallelTask::executeAsync(int id)
+{
+  TASK_ENTRY* t = findTask((size_t)id);
+  if (!t)
+    return CSTASK_FUTURE();
+  if (isTracing())
+    traceEvent('i', CSTRACE_LAUNCH, t->traceId, t->nBlocks);
+  t->background = launch(t, true);
+  return t->background;
+}
+
+CSTASK_FUTURE CS_PARALLEL_TASK_API csParallelTask::executeAsync(const char*funcName)
+{
+  return executeAsync(getId(funcName));
+}
+
+CSTASK_FUTURE CS_PARALLEL_TASK_API csParallelTask::executeAsync(void(*f)(CSPARGS))
+{
+  return executeAsync(getId(f));
+}
+
+CSTASK_FUTURE CS_PARALLEL_TASK_API csParallelTask::getBackgroundExecution(size_t idf)
+{
+  TASK_ENTRY* t = findTask(idf);
+  return t ? t->background : CSTASK_FUTURE();
+}
+
+void CS_PARALLEL_TASK_API csParallelTask::setSchedulingMode(size_t idf, int schedule, size_t chunkSize)
+{
+  if (schedule < CSSCHEDULE_STATIC || schedule > CSSCHEDULE_GUIDED)
+  {
+    cout<<"invalid scheduling mode !\n";
+    return;
   }
-  return id;
+  TASK_ENTRY* t = findTask(idf);
+  if (!t)
+    return;
+  t->schedule = schedule;
+  t->chunkSize = chunkSize;
+}
+
+int CS_PARALLEL_TASK_API csParallelTask::getSchedulingMode(size_t idf)
+{
+  TASK_ENTRY* t = findTask(idf);
+  return t ? t->schedule : CSSCHEDULE_STATIC;
+}
+
+size_t CS_PARALLEL_TASK_API csParallelTask::getChunkSize(size_t idf)
+{
+  TASK_ENTRY* t = findTask(idf);
+  return t ? t->chunkSize : 0;
+}
+
+void CS_PARALLEL_TASK_API csParallelTask::setAdaptiveShape(size_t idf, bool adaptive, double tolerance)
+{
+  TASK_ENTRY* t = findTask(idf);
+  if (!t)
+    return;
+  if (tolerance < 1.0)
+  {
+    cout<<"invalid adaptive tolerance !\n";
+    return;
+  }
+  t->tolerance = tolerance;
+  t->adaptive = adaptive;
+  resetBlockTiming(t);
+}
+
+bool CS_PARALLEL_TASK_API csParallelTask::getAdaptiveShape(size_t idf)
+{
+  TASK_ENTRY* t = findTask(idf);
+  return t ? t->adaptive : false;
+}
+
+vector<double> CS_PARALLEL_TASK_API csParallelTask::getBlockTimes(size_t idf)
+{
+  TASK_ENTRY* t = findTask(idf);
+  vector<double> times;
+  if (t)
+  {
+    for(const CSBLOCK_TIMING& m : t->blockTiming)
+      times.push_back(m.wallTime);
+  }
+  return times;
+}
+
+void CS_PARALLEL_TASK_API csParallelTask::setBlockTiming(size_t idf, bool enable)
+{
+  TASK_ENTRY* t = findTask(idf);
+  if (!t)
+    return;
+  t->timing = enable;
+  resetBlockTiming(t);
+}
+
+bool CS_PARALLEL_TASK_API csParallelTask::getBlockTiming(size_t idf)
+{
+  TASK_ENTRY* t = findTask(idf);
+  return t ? t->timing : false;
+}
+
+CSEXECUTION_TIMING CS_PARALLEL_TASK_API csParallelTask::getExecutionTiming(size_t idf)
+{
+  CSEXECUTION_TIMING e = {vector<CSBLOCK_TIMING>(), 0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+  TASK_ENTRY* t = findTask(idf);
+  if (!t || !t->timing || t->blockTiming.empty())
+    return e;
+  e.blocks = t->blockTiming;
+
+  // Les blocs executes par le thread appelant portent CSTHREAD_POOL::NO_WORKER : il compte comme un thread
+  set<size_t> threads;
+  double total = 0.0;
+  for(const CSBLOCK_TIMING& m : e.blocks)
+  {
+    threads.insert(m.worker);
+    total += m.wallTime;
+    e.span = max(e.span, m.end);
+    e.maxTime = max(e.maxTime, m.wallTime);
+    e.dispatchLatency += m.start;
+    e.maxDispatchLatency = max(e.maxDispatchLatency, m.start);
+  }
+  size_t n = e.blocks.size();
+  e.nThreads = threads.size();
+  e.meanTime = total/n;
+  e.imbalance = e.meanTime > 0.0 ? e.maxTime/e.meanTime : 0.0;
+  e.idleTime = max(0.0, e.nThreads*e.span - total);
+  e.dispatchLatency /= n;
+  return e;
+}
+
+size_t CS_PARALLEL_TASK_API csParallelTask::getBlockNumber(size_t idf)
+{
+  TASK_ENTRY* t = findTask(idf);
+  return t ? t->nBlocks : 0;
+}
+
+void CS_PARALLEL_TASK_API csParallelTask::setBlockNumber(size_t idf, size_t nBlocks)
+{
+  TASK_ENTRY* t = findTask(idf);
+  if (!t)
+    return;
+  nBlocks = getSafeThreadNumber(nBlocks);
+  if (nBlocks == 0)
+  {
+    cout<<"invalid block size !\n";
+    return;
+  }
+  if (nBlocks == t->nBlocks)
+    return;
+  CSPARGS::TILE tile = t->blocks[0].args.getTile();
+  if (tile.y.first != 0 || tile.y.last != 1 || tile.z.first != 0 || tile.z.last != 1)
+  {
+    cout<<"cannot change the block number of a tiled function !\n";
+    return;
+  }
+
+  // Les blocs lances en arriere-plan lisent encore les anciens descripteurs
+  t->background.wait();
+  t->background = CSTASK_FUTURE();
+
+  // Les nouveaux blocs reprennent le delai et le mode d'execution des anciens, puis les arguments du premier
+  BLOCK_DESC* old = t->blocks;
+  size_t oldBlocks = t->nBlocks;
+  t->blocks = new BLOCK_DESC[nBlocks];
+  for(size_t i=0; i<nBlocks; i++)
+  {
+    t->blocks[i].args.clear();
+    t->blocks[i].args = old[std::min(i, oldBlocks-1)].args;
+  }
+  t->nBlocks = nBlocks;
+  BUFFER_SHAPE shape = makeRegularBufferShape(t->workSize, nBlocks);
+  setBlockArgs(t, shape, old[0].args);
+  free(shape);
+
+  for(size_t i=0; i<oldBlocks; i++)
+    old[i].args.clear();
+  delete[] old;
+
+  resetBlockTiming(t);
+  if (t->affinity != CSAFFINITY_NONE)
+    setAffinityMode(idf, t->affinity, t->cpuList);
+}
+
+string CS_PARALLEL_TASK_API csParallelTask::getFunctionName(size_t idf)
+{
+  TASK_ENTRY* t = findTask(idf);
+  return t ? t->name : string();
+}
+
+
+void CS_PARALLEL_TASK_API csParallelTask::setThreadAffinity(int policy, vector<size_t> cpuList)
+{
+  CSTHREAD_POOL* pool = getThreadPool();
+  if (policy == CSAFFINITY_NONE)
+    pool->setAffinity(vector<size_t>());
+  else if (policy == CSAFFINITY_LIST)
+  {
+    if (cpuList.empty())
+    {
+      cout<<"empty cpu list !\n";
+      return;
+    }
+    pool->setAffinity(cpuList);
+  }
+  else if (policy == CSAFFINITY_SCATTER)
+    pool->setAffinity(getCpuOrder(CSAFFINITY_SCATTER));
+  else if (policy == CSAFFINITY_COMPACT || policy == CSAFFINITY_NUMA)
+    pool->setAffinity(getCpuOrder(CSAFFINITY_COMPACT));
+  else
+  {
+    cout<<"invalid affinity policy !\n";
+    return;
+  }
+  updatePlacements();
+}
+
+void CS_PARALLEL_TASK_API csParallelTask::setAffinityMode(size_t idf, int policy, vector<size_t> cpuList)
+{
+  TASK_ENTRY* t = findTask(idf);
+  if (!t)
+    return;
+  if (policy < CSAFFINITY_NONE || policy > CSAFFINITY_NUMA || (policy == CSAFFINITY_LIST && cpuList.empty()))
+  {
+    cout<<"invalid affinity policy !\n";
+    return;
+  }
+
+  t->affinity = policy;
+  t->cpuList = cpuList;
+  t->blockCpu.clear();
+  t->blockWorker.clear();
+  if (policy == CSAFFINITY_NONE)
+    return;
+
+  // Les blocs sont diriges vers des workers lies a un CPU : le pool est lie en mode compact s'il ne l'est pas encore
+  CSTHREAD_POOL* pool = getThreadPool();
+  if (pool->getWorkerCpu(0) == CSTHREAD_POOL::NO_CPU)
+    pool->setAffinity(getCpuOrder(CSAFFINITY_COMPACT));
+
+  size_t nBlocks = t->nBlocks;
+  if (policy == CSAFFINITY_NUMA)
+  {
+    // Tranches contigues de blocs par noeud : le bloc i retrouve toujours le meme noeud
+    size_t nNodes = getNumaNodeNumber();
+    vector<vector<size_t>> nodeCpus(nNodes);
+    for(size_t cpu : getCpuOrder(CSAFFINITY_COMPACT))
+      nodeCpus[std::min(getCpuNode(cpu), nNodes-1)].push_back(cpu);
+    vector<size_t> nodes;
+    for(size_t n=0; n<nNodes; n++)
+    {
+      if (!nodeCpus[n].empty())
+        nodes.push_back(n);
+    }
+    for(size_t i=0; i<nBlocks; i++)
+    {
+      size_t k = i*nodes.size()/nBlocks;
+      size_t firstBlock = (k*nBlocks + nodes.size() - 1)/nodes.size();
+      vector<size_t>& cpus = nodeCpus[nodes[k]];
+      t->blockCpu.push_back(cpus[(i - firstBlock) % cpus.size()]);
+    }
+  }
+  else
+  {
+    vector<size_t> order = policy == CSAFFINITY_LIST ? cpuList : getCpuOrder(policy);
+    for(size_t i=0; i<nBlocks; i++)
+      t->blockCpu.push_back(order[i % order.size()]);
+  }
+  updatePlacement(t);
+}
+
+int CS_PARALLEL_TASK_API csParallelTask::getAffinityMode(size_t idf)
+{
+  TASK_ENTRY* t = findTask(idf);
+  return t ? t->affinity : CSAFFINITY_NONE;
+}
+
+typedef struct
+{
+  TASK_ENTRY* task;
+  void (*func)(void* ctx, CSPARGS& args);
+  void* ctx;
+}FOREIGN_BLOCKS;
+
+static void runForeignBlock(void* ctx, size_t i)
+{
+  FOREIGN_BLOCKS* fb = (FOREIGN_BLOCKS*)ctx;
+  CSPARGS args = fb->task->blocks[i].args;
+  fb->func(fb->ctx, args);
+}
+
+void CS_PARALLEL_TASK_API csParallelTask::executeOnBlocks(size_t idf, void (*func)(void* ctx, CSPARGS& args), void* ctx)
+{
+  TASK_ENTRY* t = findTask(idf);
+  if (!t)
+    return;
+
+  FOREIGN_BLOCKS fb = {t, func, ctx};
+  // Memes blocs et memes workers que la fonction, sans les blocs en arriere-plan
+  vector<bool> modes;
+  for(size_t i=0; i<t->nBlocks; i++)
+  {
+    modes.push_back(t->blocks[i].args.EXEC_MODE);
+    t->blocks[i].args.EXEC_MODE = CSTHREAD_NORMAL_EXECUTION;
+  }
+  dispatch(t, runForeignBlock, &fb, false);
+  for(size_t i=0; i<t->nBlocks; i++)
+    t->blocks[i].args.EXEC_MODE = modes[i];
+}
+
+size_t CS_PARALLEL_TASK_API csParallelTask::getId(const char*funcName)
+{
+  if (!funcName)
+    return CSTASK_INVALID_ID;
+  auto it = TASK_BY_NAME.find(string_view(funcName));
+  return it != TASK_BY_NAME.end() ? it->second.front() : CSTASK_INVALID_ID;
+}
+
+size_t CS_PARALLEL_TASK_API csParallelTask::getId(void(*f)(CSPARGS))
+{
+  auto it = TASK_BY_FUNC.find((uintptr_t)f);
+  return it != TASK_BY_FUNC.end() ? it->second.front() : CSTASK_INVALID_ID;
 }
 
 void CS_PARALLEL_TASK_API csParallelTask::execute(vector<std::thread> threads)
@@ -285,50 +1364,79 @@ void CS_PARALLEL_TASK_API csParallelTask::execute(vector<std::thread> threads)
 void CS_PARALLEL_TASK_API csParallelTask::execute(const char*funcName)
 {
   size_t id = getId(funcName);
-  execute(id);
+  if (id == CSTASK_INVALID_ID)
+  {
+    cout<<"unknown function name !\n";
+    return;
+  }
+  execute((int)id);
 }
 
 void csParallelTask::execute(void(*f)(CSPARGS))
 {
   size_t id = getId(f);
-  execute(id);
+  if (id == CSTASK_INVALID_ID)
+  {
+    cout<<"unknown function !\n";
+    return;
+  }
+  execute((int)id);
 }
 
 size_t CS_PARALLEL_TASK_API csParallelTask::getWorkSize(int idf)
 {
-    return THREAD_GLOBAL_SIZE[idf];
+    TASK_ENTRY* t = findTask((size_t)idf);
+    return t ? t->workSize : 0;
 }
 
 void CS_PARALLEL_TASK_API csParallelTask::setBufferShape(size_t idf, BUFFER_SHAPE shape)
 {
-  size_t nBlocks = BLOCK_ARGS[idf].size();
-  vector<CSPARGS> parg = BLOCK_ARGS[idf];
-  for(size_t i=0; i<nBlocks; i++)
+  TASK_ENTRY* t = findTask(idf);
+  if (!t)
+    return;
+  for(size_t i=0; i<t->nBlocks; i++)
+  {
+    t->blocks[i].args.setBounds(shape[i]);
+    t->blocks[i].args.setTile({shape[i], {0,1}, {0,1}});
+  }
+}
+
+void CS_PARALLEL_TASK_API csParallelTask::setTileShape(size_t idf, TILE_SHAPE shape)
+{
+  TASK_ENTRY* t = findTask(idf);
+  if (!t)
+    return;
+  for(size_t i=0; i<t->nBlocks; i++)
   {
-    parg[i].setBounds(shape[i]);
+    t->blocks[i].args.setBounds(shape[i].y);
+    t->blocks[i].args.setTile(shape[i]);
   }
 }
 
 void CS_PARALLEL_TASK_API csParallelTask::setDelay(size_t idf, size_t delay)
 {
-    size_t nBlocks = BLOCK_ARGS[idf].size();
-    for(size_t i=0; i<nBlocks; i++)
+    TASK_ENTRY* t = findTask(idf);
+    if (!t)
+        return;
+    for(size_t i=0; i<t->nBlocks; i++)
     {
-        BLOCK_ARGS[idf][i].setDelay(delay);
+        t->blocks[i].args.setDelay(delay);
     }
 }
 
 void CS_PARALLEL_TASK_API csParallelTask::setDelay(size_t idf, vector<size_t> delayList)
 {
-    size_t nBlocks = BLOCK_ARGS[idf].size();
-    if (nBlocks > delayList.size())
+    TASK_ENTRY* t = findTask(idf);
+    if (!t)
+        return;
+    if (t->nBlocks > delayList.size())
     {
         perror("Incomplete delay list !");
         return;
     }
-    for(size_t i=0; i<nBlocks; i++)
+    for(size_t i=0; i<t->nBlocks; i++)
     {
-        BLOCK_ARGS[idf][i].setDelay(delayList[i]);
+        t->blocks[i].args.setDelay(delayList[i]);
     }
 }
 
@@ -336,63 +1444,82 @@ void CS_PARALLEL_TASK_API csParallelTask::setBufferShapeRegular(size_t idf, size
 {
   if(csParallelTask::getWorkSize(idf) != workSize)
   {
-      size_t nBlocks = BLOCK_ARGS[idf].size();
-      BUFFER_SHAPE shape = makeRegularBufferShape(workSize, nBlocks);
+      TASK_ENTRY* t = findTask(idf);
+      if (!t)
+        return;
+      BUFFER_SHAPE shape = makeRegularBufferShape(workSize, t->nBlocks);
       setBufferShape(idf,shape);
       free(shape);
-      THREAD_GLOBAL_SIZE[idf] = workSize;
+      t->workSize = workSize;
+      for(size_t i=0; i<t->nBlocks; i++)
+      {
+        t->blocks[i].args.setWorkSize(workSize);
+      }
   }
 }
 
 void CS_PARALLEL_TASK_API csParallelTask::setExecutionMode(size_t idf, bool execMode)
 {
-  size_t nBlocks = BLOCK_ARGS[idf].size();
-  for(int i=0; i<nBlocks; i++)
+  TASK_ENTRY* t = findTask(idf);
+  if (!t)
+    return;
+  for(size_t i=0; i<t->nBlocks; i++)
   {
-      BLOCK_ARGS[idf][i].EXEC_MODE = execMode;
+      t->blocks[i].args.EXEC_MODE = execMode;
   }
 }
 
 void CS_PARALLEL_TASK_API csParallelTask::setExecutionMode(size_t idf, vector<bool> execMode)
 {
-  size_t nBlocks = BLOCK_ARGS[idf].size();
-  if (nBlocks > execMode.size())
+  TASK_ENTRY* t = findTask(idf);
+  if (!t)
+    return;
+  if (t->nBlocks > execMode.size())
   {
       perror("Incomplete execMode list !");
       return;
   }
-  for(int i=0; i<nBlocks; i++)
+  for(size_t i=0; i<t->nBlocks; i++)
   {
-      BLOCK_ARGS[idf][i].EXEC_MODE = execMode[i];
+      t->blocks[i].args.EXEC_MODE = execMode[i];
   }
 }
 
 void CS_PARALLEL_TASK_API csParallelTask::updateArg(size_t idf, size_t ida, void*&&arg)
 {
-  size_t nBlocks = BLOCK_ARGS[idf].size();
-  vector<CSPARGS> parg = BLOCK_ARGS[idf];
+  TASK_ENTRY* t = findTask(idf);
+  if (!t)
+    return;
+  size_t nBlocks = t->nBlocks;
+  BLOCK_DESC* parg = t->blocks;
   for(size_t i=0; i<nBlocks; i++)
   {
-    parg[i].setArg(ida,arg);
+    parg[i].args.setArg(ida,arg);
   }
 }
 
 template<size_t N> void CS_PARALLEL_TASK_API csParallelTask::updateArg(size_t idf, const size_t (&ida)[N], void* const (&arg)[N])
 {
-  size_t nBlocks = BLOCK_ARGS[idf].size();
-  vector<CSPARGS>parg = BLOCK_ARGS[idf];
+  TASK_ENTRY* t = findTask(idf);
+  if (!t)
+    return;
+  size_t nBlocks = t->nBlocks;
+  BLOCK_DESC* parg = t->blocks;
 
   for(size_t i=0; i<nBlocks; i++)
   {
     for(size_t j=0; j<N; j++)
-      parg[i].setArg(ida[j],arg[j]);
+      parg[i].args.setArg(ida[j],arg[j]);
   }
 }
 
 void CS_PARALLEL_TASK_API csParallelTask::updateArg(size_t idf, initializer_list<size_t>ida, initializer_list<void*> arg)
 {
-  size_t nBlocks = BLOCK_ARGS[idf].size();
-  vector<CSPARGS>parg = BLOCK_ARGS[idf];
+  TASK_ENTRY* t = findTask(idf);
+  if (!t)
+    return;
+  size_t nBlocks = t->nBlocks;
+  BLOCK_DESC* parg = t->blocks;
 
   for(size_t i=0; i<nBlocks; i++)
   {
@@ -401,7 +1528,7 @@ void CS_PARALLEL_TASK_API csParallelTask::updateArg(size_t idf, initializer_list
     for(size_t id : ida)
     {
       advance(a,j);
-      parg[i].setArg(id,*a);
+      parg[i].args.setArg(id,*a);
       j++;
     }
   }
@@ -409,11 +1536,14 @@ void CS_PARALLEL_TASK_API csParallelTask::updateArg(size_t idf, initializer_list
 
 template<class T>void CS_PARALLEL_TASK_API csParallelTask::updateArg(size_t idf, size_t ida, T arg)
 {
-  size_t nBlocks = BLOCK_ARGS[idf].size();
-  vector<CSPARGS>parg = BLOCK_ARGS[idf];
+  TASK_ENTRY* t = findTask(idf);
+  if (!t)
+    return;
+  size_t nBlocks = t->nBlocks;
+  BLOCK_DESC* parg = t->blocks;
   for(size_t i=0; i<nBlocks; i++)
   {
-    *(T*)parg[i] = arg;
+    *(T*)parg[i].args = arg;
   }
 }
 
@@ -0,0 +1,22 @@
+#ifndef CSPARALLEL_INTERNAL_H_INCLUDED
+#define CSPARALLEL_INTERNAL_H_INCLUDED
+
+#include "csParallel.h"
+
+// Fonctions partagees entre les modules de la bibliotheque, hors API publique
+
+namespace csParallelTask
+{
+
+/**
+ * @brief Returns the pool task function and context that run one block of the function @p idf following its scheduling mode.
+ * Each block index in [0, getBlockNumber(idf)) must be run exactly once: the context is released after the last block.
+ * @param idf Index of the function.
+ * @param func Output task function.
+ * @param ctx Output task context.
+ */
+void prepareBlocks(size_t idf, CSTHREAD_POOL::TASK_FUNC* func, void** ctx);
+
+}
+
+#endif // CSPARALLEL_INTERNAL_H_INCLUDED
@@ -1,4 +1,5 @@
 #include "csPargs.h"
+#include <algorithm>
 
 std::mutex _mutex;
 
@@ -12,8 +13,12 @@ void CSPARGS::init(size_t _nbArgs)
     Args = 0;
     nbArgs = _nbArgs;
     bounds = {0,0};
+    tile = {{0,0}, {0,1}, {0,1}};
     blockId = 0;
     workSize = 0;
+    chunkSource = 0;
+    chunkCount = 0;
+    ownArgs = true;
     Args = (void**)malloc(sizeof(void*)*(nbArgs+2));
     Args[1] = (void*)&bounds;
     Args[0] = (void*)&blockId;
@@ -35,6 +40,16 @@ void CSPARGS::setBounds(CSPARGS::BOUNDS b)
 
 }
 
+CSPARGS::TILE CSPARGS::getTile()
+{
+    return tile;
+}
+
+void CSPARGS::setTile(CSPARGS::TILE t)
+{
+    tile = t;
+}
+
 void CSPARGS::setWorkSize(size_t _workSize)
 {
     workSize = _workSize;
@@ -121,12 +136,57 @@ void CSPARGS::getBounds(size_t workSize, size_t*min, size_t*max)
     *max = (blockId + 1)*delta;
 }
 
+bool CSPARGS::nextChunk(CSPARGS::BOUNDS& chunk)
+{
+  if (chunkCount == 0)
+  {
+    chunkCount++;
+    chunk = bounds;
+    return bounds.first < bounds.last;
+  }
+
+  if (!chunkSource || !chunkSource->claim(chunkSource->ctx, blockId, chunk))
+    return false;
+
+  bounds = chunk;
+  chunkCount++;
+  return true;
+}
+
+void CSPARGS::setChunkSource(CSPARGS::CHUNK_SOURCE* source)
+{
+  chunkSource = source;
+  chunkCount = 0;
+}
 
 void CSPARGS::setArgNumber(size_t _nbArgs)
 {
+    int m = _nbArgs + 2;
+    if (!ownArgs)
+    {
+        // Table externe : copie dans une allocation propre avant de la redimensionner
+        void** own = (void**)malloc(m*sizeof(void*));
+        for(size_t i=0; i<std::min(nbArgs, _nbArgs)+2; i++)
+            own[i] = Args[i];
+        Args = own;
+        ownArgs = true;
+    }
+    else
+        Args = (void**)realloc(Args, m*sizeof(void*));
+    nbArgs = _nbArgs;
+    Args[1] = (void*)&bounds;
+    Args[0] = (void*)&blockId;
+}
+
+void CSPARGS::setArgStorage(void** storage, size_t _nbArgs)
+{
+    if (ownArgs)
+        free(Args);
+    Args = storage;
+    ownArgs = false;
     nbArgs = _nbArgs;
-    int m = nbArgs + 2;
-    Args = (void**)realloc(Args, m*sizeof(void*));
+    Args[1] = (void*)&bounds;
+    Args[0] = (void*)&blockId;
 }
 
 
@@ -160,18 +220,23 @@ void CSPARGS::regArgs2(void**args, size_t nbArgs)
     }
 }
 
-void CSPARGS::lockGuard()
+std::unique_lock<std::mutex> CSPARGS::lockGuard()
 {
-    std::lock_guard<std::mutex> lock(_mutex);
+    // Le verrou appartient a l'objet retourne : il est libere a la fin de la portee de l'appelant
+    return std::unique_lock<std::mutex>(_mutex);
 }
 
 void CSPARGS::clear()
 {
-    free(Args);
+    if (ownArgs)
+        free(Args);
     Args = 0;
+    ownArgs = true;
     bounds = {0};
     blockId = 0;
     workSize = 0;
+    chunkSource = 0;
+    chunkCount = 0;
 }
 
 CSPARGS::operator CSPARGS::BOUNDS()
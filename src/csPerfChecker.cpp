@@ -1,10 +1,46 @@
+#include <cstring>
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
 #include "csPerfChecker.h"
+#include "csParallel.h"
+
+#ifdef __linux__
+static const uint64_t COUNTER_CONFIGS[CSPERF_COUNTER_NUMBER] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+  PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES, PERF_COUNT_HW_STALLED_CYCLES_BACKEND};
+
+// Compteur de l'espace utilisateur d'un thread (0 pour le thread appelant), cree desactive
+static int openCounter(int counter, pid_t tid)
+{
+  perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = COUNTER_CONFIGS[counter];
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  return (int)syscall(SYS_perf_event_open, &attr, tid, -1, -1, PERF_FLAG_FD_CLOEXEC);
+}
+#endif
+
+static const char* COUNTER_NAMES[CSPERF_COUNTER_NUMBER] = {"Cycles", "Instructions", "LLC misses", "Branch misses", "Stalled cycles"};
 
 CSPERF_CHECKER::CSPERF_CHECKER(int _unit)
 {
+    memset(&counters, 0, sizeof(counters));
     setTimeUnit(_unit);
 }
 
+CSPERF_CHECKER::~CSPERF_CHECKER()
+{
+  closeCounters();
+}
+
 void CSPERF_CHECKER::setTimeUnit(int _unit)
 {
     unit = _unit;
@@ -12,12 +48,15 @@ void CSPERF_CHECKER::setTimeUnit(int _unit)
 
 void CSPERF_CHECKER::start()
 {
+   openCounters();
    strt = std::chrono::high_resolution_clock::now();
 }
 
 void CSPERF_CHECKER::stop()
 {
   stp = std::chrono::high_resolution_clock::now();
+  closeCounters();
+  ellapsedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(stp - strt).count();
   // Calculer la dur�e en microsecondes (ou autre unit�)
 
   switch (unit)
@@ -59,9 +98,138 @@ void CSPERF_CHECKER::printReport(const char* title)
 {
   std::cout<< title;
   std::cout << "Execution time : " << ellapsed << unitName << " \n";
+  if (counterMode == CSPERF_COUNTERS_OFF)
+    return;
+  if (!hasCounters())
+  {
+    std::cout << "hardware counters unavailable !\n";
+    return;
+  }
+  for(int c=0; c<CSPERF_COUNTER_NUMBER; c++)
+  {
+    if (!counters.available[c])
+      continue;
+    std::cout << COUNTER_NAMES[c] << " : " << counters.value[c];
+    if (c == CSPERF_INSTRUCTIONS && counters.available[CSPERF_CYCLES])
+      std::cout << " (IPC " << getInstructionsPerCycle() << ")";
+    std::cout << " \n";
+  }
+  std::cout << "Counted threads : " << counters.threads << " \n";
 }
 
 size_t CSPERF_CHECKER::getEllapsedTime()
 {
   return ellapsed;
 }
+
+uint64_t CSPERF_CHECKER::getEllapsedNanoseconds()
+{
+  return ellapsedNs;
+}
+
+void CSPERF_CHECKER::setCounterMode(int mode)
+{
+  counterMode = mode;
+}
+
+int CSPERF_CHECKER::getCounterMode()
+{
+  return counterMode;
+}
+
+bool CSPERF_CHECKER::hasCounters()
+{
+  for(int c=0; c<CSPERF_COUNTER_NUMBER; c++)
+  {
+    if (counters.available[c])
+      return true;
+  }
+  return false;
+}
+
+CSPERF_COUNTERS CSPERF_CHECKER::getCounters()
+{
+  return counters;
+}
+
+uint64_t CSPERF_CHECKER::getCounter(int counter)
+{
+  if (counter < 0 || counter >= CSPERF_COUNTER_NUMBER || !counters.available[counter])
+    return 0;
+  return counters.value[counter];
+}
+
+double CSPERF_CHECKER::getInstructionsPerCycle()
+{
+  if (!counters.available[CSPERF_CYCLES] || !counters.available[CSPERF_INSTRUCTIONS] || counters.value[CSPERF_CYCLES] == 0)
+    return 0.0;
+  return (double)counters.value[CSPERF_INSTRUCTIONS] / counters.value[CSPERF_CYCLES];
+}
+
+void CSPERF_CHECKER::openCounters()
+{
+  closeCounters();
+  memset(&counters, 0, sizeof(counters));
+  if (counterMode == CSPERF_COUNTERS_OFF)
+    return;
+#ifdef __linux__
+  std::vector<pid_t> tids(1, 0);
+  if (counterMode == CSPERF_COUNTERS_WORKERS)
+  {
+    CSTHREAD_POOL* pool = csParallelTask::getThreadPool();
+    size_t n = pool->getWorkerNumber();
+    for(size_t w=0; w<n; w++)
+    {
+      size_t id = pool->getWorkerSystemId(w);
+      if (id != 0)
+        tids.push_back((pid_t)id);
+    }
+  }
+  for(size_t t=0; t<tids.size(); t++)
+  {
+    bool opened = false;
+    for(int c=0; c<CSPERF_COUNTER_NUMBER; c++)
+    {
+      int fd = openCounter(c, tids[t]);
+      if (fd < 0)
+        continue;
+      counterFds.push_back(fd);
+      counterIds.push_back(c);
+      opened = true;
+    }
+    // Sans compteur sur le thread appelant, les workers n'en auront pas davantage
+    if (!opened && t == 0)
+      return;
+    if (opened)
+      counters.threads++;
+  }
+  for(size_t k=0; k<counterFds.size(); k++)
+  {
+    ioctl(counterFds[k], PERF_EVENT_IOC_RESET, 0);
+    ioctl(counterFds[k], PERF_EVENT_IOC_ENABLE, 0);
+  }
+#endif
+}
+
+void CSPERF_CHECKER::closeCounters()
+{
+#ifdef __linux__
+  // Tout arreter avant de lire, pour que chaque compteur couvre le meme intervalle
+  for(size_t k=0; k<counterFds.size(); k++)
+    ioctl(counterFds[k], PERF_EVENT_IOC_DISABLE, 0);
+  for(size_t k=0; k<counterFds.size(); k++)
+  {
+    // Valeur, temps active et temps compte : le rapport corrige le multiplexage des compteurs
+    uint64_t data[3];
+    if (read(counterFds[k], data, sizeof(data)) == (ssize_t)sizeof(data) && data[2] > 0)
+    {
+      int c = counterIds[k];
+      counters.value[c] += (uint64_t)((double)data[0] * data[1] / data[2]);
+      counters.available[c] = true;
+    }
+    close(counterFds[k]);
+  }
+#endif
+  counterFds.clear();
+  counterIds.clear();
+}
@@ -0,0 +1,226 @@
+#include <iostream>
+#include <atomic>
+#include <limits>
+#include "csSimdKernels.h"
+
+#if defined __x86_64__ || defined _M_X64 || defined __i386__ || defined _M_IX86
+  #define CSSIMD_X86
+  #ifdef _MSC_VER
+    #include <intrin.h>
+  #endif
+#endif
+
+using namespace std;
+
+// Jeu d'instructions "scalaire" : un registre d'une seule ligne, avec les memes noyaux generiques
+template<class S> struct SCALAR_LANE
+{
+  typedef S T;
+  typedef S R;
+  static const size_t W = 1;
+  static R load(const T* p) { return *p; }
+  static void store(T* p, R v) { *p = v; }
+  static R set1(T v) { return v; }
+  static R add(R a, R b) { return addWrap(a, b); }
+  static R sub(R a, R b) { return a - b; }
+  static R mul(R a, R b) { return mulWrap(a, b); }
+  static R madd(R a, R b, R c) { return addWrap(mulWrap(a, b), c); }
+  static R min(R a, R b) { return b < a ? b : a; }
+  static R max(R a, R b) { return b > a ? b : a; }
+  static T reduceAdd(R v) { return v; }
+  static T reduceMin(R v) { return v; }
+  static T reduceMax(R v) { return v; }
+};
+
+static int64_t sumIntScalar(const int32_t* x, size_t n)
+{
+  int64_t s = 0;
+  for(size_t i=0; i<n; i++)
+    s += x[i];
+  return s;
+}
+
+static int64_t dotIntScalar(const int32_t* x, const int32_t* y, size_t n)
+{
+  int64_t s = 0;
+  for(size_t i=0; i<n; i++)
+    s += (int64_t)x[i]*y[i];
+  return s;
+}
+
+static void fillSimdKernelsScalar(SIMD_KERNELS* k)
+{
+  fillFloatKernels<SCALAR_LANE<double>, SCALAR_LANE<float>>(k);
+  fillIntKernels<SCALAR_LANE<int32_t>>(k);
+  fillIntMulKernels<SCALAR_LANE<int32_t>>(k);
+  k->sumI = sumIntScalar;
+  k->dotI = dotIntScalar;
+}
+
+static bool cpuSupports(int level)
+{
+#ifdef CSSIMD_X86
+  #ifdef _MSC_VER
+  int info[4];
+  __cpuid(info, 1);
+  bool sse2 = (info[3] & (1 << 26)) != 0;
+  bool fma = (info[2] & (1 << 12)) != 0;
+  bool osxsave = (info[2] & (1 << 27)) != 0;
+  unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+  __cpuidex(info, 7, 0);
+  bool avx2 = fma && (info[1] & (1 << 5)) != 0 && (xcr0 & 6) == 6;
+  bool avx512 = (info[1] & (1 << 16)) != 0 && (xcr0 & 0xe6) == 0xe6;
+  #else
+  __builtin_cpu_init();
+  bool sse2 = __builtin_cpu_supports("sse2");
+  bool avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+  bool avx512 = __builtin_cpu_supports("avx512f");
+  #endif
+  switch (level)
+  {
+    case CSSIMD_SSE2: return sse2;
+    case CSSIMD_AVX2: return avx2;
+    case CSSIMD_AVX512: return avx512 && avx2;
+  }
+#endif
+  return level == CSSIMD_SCALAR;
+}
+
+// Une table par niveau, chacune partant de celle du niveau inferieur ; cpuLevel est le meilleur niveau disponible
+static SIMD_KERNELS levelTables[CSSIMD_AVX512+1];
+static int cpuLevel = CSSIMD_SCALAR;
+
+static bool buildTables()
+{
+  bool (*fill[])(SIMD_KERNELS*) = {0, fillSimdKernelsSse2, fillSimdKernelsAvx2, fillSimdKernelsAvx512};
+  fillSimdKernelsScalar(&levelTables[CSSIMD_SCALAR]);
+  for(int level=CSSIMD_SSE2; level<=CSSIMD_AVX512; level++)
+  {
+    levelTables[level] = levelTables[level-1];
+    if (cpuLevel == level-1 && fill[level](&levelTables[level]) && cpuSupports(level))
+      cpuLevel = level;
+  }
+  return true;
+}
+
+static atomic<int> simdLevel(-1);
+
+static const SIMD_KERNELS* kernels()
+{
+  static const bool built = buildTables();
+  (void)built;
+  int level = simdLevel.load(memory_order_relaxed);
+  if (level < 0)
+    level = cpuLevel;
+  return &levelTables[level];
+}
+
+int CS_PARALLEL_TASK_API csParallelTask::getCpuSimdLevel()
+{
+  kernels();
+  return cpuLevel;
+}
+
+bool CS_PARALLEL_TASK_API csParallelTask::setSimdLevel(int level)
+{
+  if (level < CSSIMD_SCALAR || level > getCpuSimdLevel())
+  {
+    cout<<"unsupported SIMD level !\n";
+    return false;
+  }
+  simdLevel = level;
+  return true;
+}
+
+int CS_PARALLEL_TASK_API csParallelTask::getSimdLevel()
+{
+  int level = simdLevel;
+  return level < 0 ? getCpuSimdLevel() : level;
+}
+
+CS_PARALLEL_TASK_API const char* csParallelTask::getSimdLevelName(int level)
+{
+  static const char* names[] = {"scalar", "sse2", "avx2", "avx512"};
+  return level >= CSSIMD_SCALAR && level <= CSSIMD_AVX512 ? names[level] : "unknown";
+}
+
+double CS_PARALLEL_TASK_API csParallelTask::simdSum(const double* x, size_t n) { return kernels()->sumD(x, n); }
+float CS_PARALLEL_TASK_API csParallelTask::simdSum(const float* x, size_t n) { return kernels()->sumF(x, n); }
+int64_t CS_PARALLEL_TASK_API csParallelTask::simdSum(const int32_t* x, size_t n) { return kernels()->sumI(x, n); }
+
+double CS_PARALLEL_TASK_API csParallelTask::simdKahanSum(const double* x, size_t n) { return kernels()->kahanSumD(x, n); }
+float CS_PARALLEL_TASK_API csParallelTask::simdKahanSum(const float* x, size_t n) { return kernels()->kahanSumF(x, n); }
+
+double CS_PARALLEL_TASK_API csParallelTask::simdSumSquares(const double* x, size_t n) { return kernels()->sumSquaresD(x, n); }
+float CS_PARALLEL_TASK_API csParallelTask::simdSumSquares(const float* x, size_t n) { return kernels()->sumSquaresF(x, n); }
+
+double CS_PARALLEL_TASK_API csParallelTask::simdDot(const double* x, const double* y, size_t n) { return kernels()->dotD(x, y, n); }
+float CS_PARALLEL_TASK_API csParallelTask::simdDot(const float* x, const float* y, size_t n) { return kernels()->dotF(x, y, n); }
+int64_t CS_PARALLEL_TASK_API csParallelTask::simdDot(const int32_t* x, const int32_t* y, size_t n) { return kernels()->dotI(x, y, n); }
+
+// Les noyaux min/max supposent au moins un element
+double CS_PARALLEL_TASK_API csParallelTask::simdMin(const double* x, size_t n) { return n ? kernels()->minD(x, n) : numeric_limits<double>::max(); }
+float CS_PARALLEL_TASK_API csParallelTask::simdMin(const float* x, size_t n) { return n ? kernels()->minF(x, n) : numeric_limits<float>::max(); }
+int32_t CS_PARALLEL_TASK_API csParallelTask::simdMin(const int32_t* x, size_t n) { return n ? kernels()->minI(x, n) : numeric_limits<int32_t>::max(); }
+
+double CS_PARALLEL_TASK_API csParallelTask::simdMax(const double* x, size_t n) { return n ? kernels()->maxD(x, n) : numeric_limits<double>::lowest(); }
+float CS_PARALLEL_TASK_API csParallelTask::simdMax(const float* x, size_t n) { return n ? kernels()->maxF(x, n) : numeric_limits<float>::lowest(); }
+int32_t CS_PARALLEL_TASK_API csParallelTask::simdMax(const int32_t* x, size_t n) { return n ? kernels()->maxI(x, n) : numeric_limits<int32_t>::lowest(); }
+
+// Premier indice de la valeur extreme : on garde le premier bloc dont l'extremum est strictement meilleur, puis on le parcourt.
+// Les noyaux min/max ne propagent pas les NaN : un bloc dont la somme est NaN (un NaN, ou des infinis de signes opposes)
+// est parcouru, et le premier NaN trouve est le resultat. La somme est nulle pour les entiers
+template<class T> static size_t argExtremum(const T* x, size_t n, T (*extremum)(const T*, size_t), T (*sum)(const T*, size_t), bool isMin)
+{
+  if (n == 0)
+    return 0;
+  size_t bestBlock = 0;
+  T best = T();
+  for(size_t first=0; first<n; first+=CSSIMD_ARG_BLOCK)
+  {
+    size_t count = n-first < CSSIMD_ARG_BLOCK ? n-first : CSSIMD_ARG_BLOCK;
+    T m = extremum(x + first, count);
+    if (sum)
+    {
+      T s = sum(x + first, count);
+      for(size_t i=first; s != s && i<first+count; i++)
+      {
+        if (x[i] != x[i])
+          return i;
+      }
+    }
+    if (first == 0 || (isMin ? m < best : m > best))
+    {
+      best = m;
+      bestBlock = first;
+    }
+  }
+  // Sans NaN, le bloc retenu contient la valeur ; le parcours reste borne a ce bloc
+  size_t last = n-bestBlock < CSSIMD_ARG_BLOCK ? n : bestBlock+CSSIMD_ARG_BLOCK;
+  for(size_t i=bestBlock; i<last; i++)
+  {
+    if (x[i] == best)
+      return i;
+  }
+  return bestBlock;
+}
+
+size_t CS_PARALLEL_TASK_API csParallelTask::simdArgMin(const double* x, size_t n) { return argExtremum(x, n, kernels()->minD, kernels()->sumD, true); }
+size_t CS_PARALLEL_TASK_API csParallelTask::simdArgMin(const float* x, size_t n) { return argExtremum(x, n, kernels()->minF, kernels()->sumF, true); }
+size_t CS_PARALLEL_TASK_API csParallelTask::simdArgMin(const int32_t* x, size_t n) { return argExtremum<int32_t>(x, n, kernels()->minI, 0, true); }
+
+size_t CS_PARALLEL_TASK_API csParallelTask::simdArgMax(const double* x, size_t n) { return argExtremum(x, n, kernels()->maxD, kernels()->sumD, false); }
+size_t CS_PARALLEL_TASK_API csParallelTask::simdArgMax(const float* x, size_t n) { return argExtremum(x, n, kernels()->maxF, kernels()->sumF, false); }
+size_t CS_PARALLEL_TASK_API csParallelTask::simdArgMax(const int32_t* x, size_t n) { return argExtremum<int32_t>(x, n, kernels()->maxI, 0, false); }
+
+void CS_PARALLEL_TASK_API csParallelTask::simdAxpy(double a, const double* x, double* y, size_t n) { kernels()->axpyD(a, x, y, n); }
+void CS_PARALLEL_TASK_API csParallelTask::simdAxpy(float a, const float* x, float* y, size_t n) { kernels()->axpyF(a, x, y, n); }
+void CS_PARALLEL_TASK_API csParallelTask::simdAxpy(int32_t a, const int32_t* x, int32_t* y, size_t n) { kernels()->axpyI(a, x, y, n); }
+
+void CS_PARALLEL_TASK_API csParallelTask::simdScale(double* x, size_t n, double a) { kernels()->scaleD(x, n, a); }
+void CS_PARALLEL_TASK_API csParallelTask::simdScale(float* x, size_t n, float a) { kernels()->scaleF(x, n, a); }
+void CS_PARALLEL_TASK_API csParallelTask::simdScale(int32_t* x, size_t n, int32_t a) { kernels()->scaleI(x, n, a); }
+
+void CS_PARALLEL_TASK_API csParallelTask::simdFill(double* x, size_t n, double value) { kernels()->fillD(x, n, value); }
+void CS_PARALLEL_TASK_API csParallelTask::simdFill(float* x, size_t n, float value) { kernels()->fillF(x, n, value); }
+void CS_PARALLEL_TASK_API csParallelTask::simdFill(int32_t* x, size_t n, int32_t value) { kernels()->fillI(x, n, value); }
@@ -0,0 +1,130 @@
+#include "csSimdKernels.h"
+
+// Noyaux AVX2 + FMA (registres de 256 bits). Ce module est compile avec -mavx2 -mfma ;
+// il n'est appele que si le CPU annonce ces extensions.
+
+#if (defined __AVX2__ && defined __FMA__) || (defined _MSC_VER && (defined _M_X64 || defined _M_IX86))
+#include <immintrin.h>
+
+namespace
+{
+
+struct AVX2_D
+{
+  typedef double T;
+  typedef __m256d R;
+  static const size_t W = 4;
+  static R load(const T* p) { return _mm256_loadu_pd(p); }
+  static void store(T* p, R v) { _mm256_storeu_pd(p, v); }
+  static R set1(T v) { return _mm256_set1_pd(v); }
+  static R add(R a, R b) { return _mm256_add_pd(a, b); }
+  static R sub(R a, R b) { return _mm256_sub_pd(a, b); }
+  static R mul(R a, R b) { return _mm256_mul_pd(a, b); }
+  static R madd(R a, R b, R c) { return _mm256_fmadd_pd(a, b, c); }
+  static R min(R a, R b) { return _mm256_min_pd(a, b); }
+  static R max(R a, R b) { return _mm256_max_pd(a, b); }
+  static T reduceAdd(R v) { return lanesAdd<AVX2_D>(v); }
+  static T reduceMin(R v) { return lanesMin<AVX2_D>(v); }
+  static T reduceMax(R v) { return lanesMax<AVX2_D>(v); }
+};
+
+struct AVX2_F
+{
+  typedef float T;
+  typedef __m256 R;
+  static const size_t W = 8;
+  static R load(const T* p) { return _mm256_loadu_ps(p); }
+  static void store(T* p, R v) { _mm256_storeu_ps(p, v); }
+  static R set1(T v) { return _mm256_set1_ps(v); }
+  static R add(R a, R b) { return _mm256_add_ps(a, b); }
+  static R sub(R a, R b) { return _mm256_sub_ps(a, b); }
+  static R mul(R a, R b) { return _mm256_mul_ps(a, b); }
+  static R madd(R a, R b, R c) { return _mm256_fmadd_ps(a, b, c); }
+  static R min(R a, R b) { return _mm256_min_ps(a, b); }
+  static R max(R a, R b) { return _mm256_max_ps(a, b); }
+  static T reduceAdd(R v) { return lanesAdd<AVX2_F>(v); }
+  static T reduceMin(R v) { return lanesMin<AVX2_F>(v); }
+  static T reduceMax(R v) { return lanesMax<AVX2_F>(v); }
+};
+
+struct AVX2_I
+{
+  typedef int32_t T;
+  typedef __m256i R;
+  static const size_t W = 8;
+  static R load(const T* p) { return _mm256_loadu_si256((const __m256i*)p); }
+  static void store(T* p, R v) { _mm256_storeu_si256((__m256i*)p, v); }
+  static R set1(T v) { return _mm256_set1_epi32(v); }
+  static R add(R a, R b) { return _mm256_add_epi32(a, b); }
+  static R sub(R a, R b) { return _mm256_sub_epi32(a, b); }
+  static R mul(R a, R b) { return _mm256_mullo_epi32(a, b); }
+  static R madd(R a, R b, R c) { return _mm256_add_epi32(_mm256_mullo_epi32(a, b), c); }
+  static R min(R a, R b) { return _mm256_min_epi32(a, b); }
+  static R max(R a, R b) { return _mm256_max_epi32(a, b); }
+  static T reduceAdd(R v) { return lanesAdd<AVX2_I>(v); }
+  static T reduceMin(R v) { return lanesMin<AVX2_I>(v); }
+  static T reduceMax(R v) { return lanesMax<AVX2_I>(v); }
+};
+
+int64_t reduceInt64(__m256i v)
+{
+  int64_t l[4];
+  _mm256_storeu_si256((__m256i*)l, v);
+  return l[0] + l[1] + l[2] + l[3];
+}
+
+// Somme int32 sur des accumulateurs 64 bits
+int64_t sumInt(const int32_t* x, size_t n)
+{
+  __m256i s0 = _mm256_setzero_si256(), s1 = _mm256_setzero_si256();
+  size_t i = 0;
+  for(; i+8<=n; i+=8)
+  {
+    s0 = _mm256_add_epi64(s0, _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i*)(x + i))));
+    s1 = _mm256_add_epi64(s1, _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i*)(x + i + 4))));
+  }
+  int64_t s = reduceInt64(_mm256_add_epi64(s0, s1));
+  for(; i<n; i++)
+    s += x[i];
+  return s;
+}
+
+// Produit scalaire int32 : _mm256_mul_epi32 multiplie les lignes paires en 64 bits, un decalage amene les lignes impaires
+int64_t dotInt(const int32_t* x, const int32_t* y, size_t n)
+{
+  __m256i s0 = _mm256_setzero_si256(), s1 = _mm256_setzero_si256();
+  size_t i = 0;
+  for(; i+8<=n; i+=8)
+  {
+    __m256i a = _mm256_loadu_si256((const __m256i*)(x + i));
+    __m256i b = _mm256_loadu_si256((const __m256i*)(y + i));
+    s0 = _mm256_add_epi64(s0, _mm256_mul_epi32(a, b));
+    s1 = _mm256_add_epi64(s1, _mm256_mul_epi32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32)));
+  }
+  int64_t s = reduceInt64(_mm256_add_epi64(s0, s1));
+  for(; i<n; i++)
+    s += (int64_t)x[i]*y[i];
+  return s;
+}
+
+}
+
+bool fillSimdKernelsAvx2(SIMD_KERNELS* k)
+{
+  fillFloatKernels<AVX2_D, AVX2_F>(k);
+  fillIntKernels<AVX2_I>(k);
+  fillIntMulKernels<AVX2_I>(k);
+  k->sumI = sumInt;
+  k->dotI = dotInt;
+  return true;
+}
+
+#else
+
+bool fillSimdKernelsAvx2(SIMD_KERNELS* k)
+{
+  (void)k;
+  return false;
+}
+
+#endif
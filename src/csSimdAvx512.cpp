@@ -0,0 +1,136 @@
+#include "csSimdKernels.h"
+
+// Noyaux AVX-512F (registres de 512 bits). Ce module est compile avec -mavx512f ;
+// il n'est appele que si le CPU et le systeme gerent les registres zmm.
+
+#if defined __AVX512F__ || (defined _MSC_VER && defined _M_X64)
+#include <immintrin.h>
+
+namespace
+{
+
+// Avec GCC, les intrinseques AVX-512 sans masque (min, max, reduce, srli, mul_epi32...) partent d'un registre
+// _mm512_undefined_*() qui declenche -Wuninitialized. Comme dans le module AVX2, les reductions passent par
+// les lignes stockees, et les autres operations prennent un masque complet sur un registre initialise
+static const __mmask8 ALL8 = (__mmask8)0xFF;
+static const __mmask16 ALL16 = (__mmask16)0xFFFF;
+
+struct AVX512_D
+{
+  typedef double T;
+  typedef __m512d R;
+  static const size_t W = 8;
+  static R load(const T* p) { return _mm512_loadu_pd(p); }
+  static void store(T* p, R v) { _mm512_storeu_pd(p, v); }
+  static R set1(T v) { return _mm512_set1_pd(v); }
+  static R add(R a, R b) { return _mm512_add_pd(a, b); }
+  static R sub(R a, R b) { return _mm512_sub_pd(a, b); }
+  static R mul(R a, R b) { return _mm512_mul_pd(a, b); }
+  static R madd(R a, R b, R c) { return _mm512_fmadd_pd(a, b, c); }
+  static R min(R a, R b) { return _mm512_mask_min_pd(a, ALL8, a, b); }
+  static R max(R a, R b) { return _mm512_mask_max_pd(a, ALL8, a, b); }
+  static T reduceAdd(R v) { return lanesAdd<AVX512_D>(v); }
+  static T reduceMin(R v) { return lanesMin<AVX512_D>(v); }
+  static T reduceMax(R v) { return lanesMax<AVX512_D>(v); }
+};
+
+struct AVX512_F
+{
+  typedef float T;
+  typedef __m512 R;
+  static const size_t W = 16;
+  static R load(const T* p) { return _mm512_loadu_ps(p); }
+  static void store(T* p, R v) { _mm512_storeu_ps(p, v); }
+  static R set1(T v) { return _mm512_set1_ps(v); }
+  static R add(R a, R b) { return _mm512_add_ps(a, b); }
+  static R sub(R a, R b) { return _mm512_sub_ps(a, b); }
+  static R mul(R a, R b) { return _mm512_mul_ps(a, b); }
+  static R madd(R a, R b, R c) { return _mm512_fmadd_ps(a, b, c); }
+  static R min(R a, R b) { return _mm512_mask_min_ps(a, ALL16, a, b); }
+  static R max(R a, R b) { return _mm512_mask_max_ps(a, ALL16, a, b); }
+  static T reduceAdd(R v) { return lanesAdd<AVX512_F>(v); }
+  static T reduceMin(R v) { return lanesMin<AVX512_F>(v); }
+  static T reduceMax(R v) { return lanesMax<AVX512_F>(v); }
+};
+
+struct AVX512_I
+{
+  typedef int32_t T;
+  typedef __m512i R;
+  static const size_t W = 16;
+  static R load(const T* p) { return _mm512_loadu_si512(p); }
+  static void store(T* p, R v) { _mm512_storeu_si512(p, v); }
+  static R set1(T v) { return _mm512_set1_epi32(v); }
+  static R add(R a, R b) { return _mm512_add_epi32(a, b); }
+  static R sub(R a, R b) { return _mm512_sub_epi32(a, b); }
+  static R mul(R a, R b) { return _mm512_mullo_epi32(a, b); }
+  static R madd(R a, R b, R c) { return _mm512_add_epi32(_mm512_mullo_epi32(a, b), c); }
+  static R min(R a, R b) { return _mm512_mask_min_epi32(a, ALL16, a, b); }
+  static R max(R a, R b) { return _mm512_mask_max_epi32(a, ALL16, a, b); }
+  static T reduceAdd(R v) { return lanesAdd<AVX512_I>(v); }
+  static T reduceMin(R v) { return lanesMin<AVX512_I>(v); }
+  static T reduceMax(R v) { return lanesMax<AVX512_I>(v); }
+};
+
+int64_t reduceInt64(__m512i v)
+{
+  int64_t l[8];
+  _mm512_storeu_si512(l, v);
+  return l[0] + l[1] + l[2] + l[3] + l[4] + l[5] + l[6] + l[7];
+}
+
+// Somme int32 sur des accumulateurs 64 bits
+int64_t sumInt(const int32_t* x, size_t n)
+{
+  __m512i s0 = _mm512_setzero_si512(), s1 = _mm512_setzero_si512();
+  size_t i = 0;
+  for(; i+16<=n; i+=16)
+  {
+    s0 = _mm512_add_epi64(s0, _mm512_maskz_cvtepi32_epi64(ALL8, _mm256_loadu_si256((const __m256i*)(x + i))));
+    s1 = _mm512_add_epi64(s1, _mm512_maskz_cvtepi32_epi64(ALL8, _mm256_loadu_si256((const __m256i*)(x + i + 8))));
+  }
+  int64_t s = reduceInt64(_mm512_add_epi64(s0, s1));
+  for(; i<n; i++)
+    s += x[i];
+  return s;
+}
+
+// Produit scalaire int32 : lignes paires puis impaires multipliees en 64 bits
+int64_t dotInt(const int32_t* x, const int32_t* y, size_t n)
+{
+  __m512i s0 = _mm512_setzero_si512(), s1 = _mm512_setzero_si512();
+  size_t i = 0;
+  for(; i+16<=n; i+=16)
+  {
+    __m512i a = _mm512_loadu_si512(x + i);
+    __m512i b = _mm512_loadu_si512(y + i);
+    s0 = _mm512_add_epi64(s0, _mm512_maskz_mul_epi32(ALL8, a, b));
+    s1 = _mm512_add_epi64(s1, _mm512_maskz_mul_epi32(ALL8, _mm512_maskz_srli_epi64(ALL8, a, 32), _mm512_maskz_srli_epi64(ALL8, b, 32)));
+  }
+  int64_t s = reduceInt64(_mm512_add_epi64(s0, s1));
+  for(; i<n; i++)
+    s += (int64_t)x[i]*y[i];
+  return s;
+}
+
+}
+
+bool fillSimdKernelsAvx512(SIMD_KERNELS* k)
+{
+  fillFloatKernels<AVX512_D, AVX512_F>(k);
+  fillIntKernels<AVX512_I>(k);
+  fillIntMulKernels<AVX512_I>(k);
+  k->sumI = sumInt;
+  k->dotI = dotInt;
+  return true;
+}
+
+#else
+
+bool fillSimdKernelsAvx512(SIMD_KERNELS* k)
+{
+  (void)k;
+  return false;
+}
+
+#endif
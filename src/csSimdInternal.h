@@ -0,0 +1,47 @@
+#ifndef CSSIMD_INTERNAL_H_INCLUDED
+#define CSSIMD_INTERNAL_H_INCLUDED
+
+#include "csSimd.h"
+
+// Table des noyaux d'un jeu d'instructions, remplie par les modules compiles pour ce jeu (csSimdSse2.cpp, csSimdAvx2.cpp, csSimdAvx512.cpp)
+
+typedef struct
+{
+  double (*sumD)(const double*, size_t);
+  float (*sumF)(const float*, size_t);
+  int64_t (*sumI)(const int32_t*, size_t);
+  double (*kahanSumD)(const double*, size_t);
+  float (*kahanSumF)(const float*, size_t);
+  double (*sumSquaresD)(const double*, size_t);
+  float (*sumSquaresF)(const float*, size_t);
+  double (*dotD)(const double*, const double*, size_t);
+  float (*dotF)(const float*, const float*, size_t);
+  int64_t (*dotI)(const int32_t*, const int32_t*, size_t);
+  double (*minD)(const double*, size_t);
+  float (*minF)(const float*, size_t);
+  int32_t (*minI)(const int32_t*, size_t);
+  double (*maxD)(const double*, size_t);
+  float (*maxF)(const float*, size_t);
+  int32_t (*maxI)(const int32_t*, size_t);
+  void (*axpyD)(double, const double*, double*, size_t);
+  void (*axpyF)(float, const float*, float*, size_t);
+  void (*axpyI)(int32_t, const int32_t*, int32_t*, size_t);
+  void (*scaleD)(double*, size_t, double);
+  void (*scaleF)(float*, size_t, float);
+  void (*scaleI)(int32_t*, size_t, int32_t);
+  void (*fillD)(double*, size_t, double);
+  void (*fillF)(float*, size_t, float);
+  void (*fillI)(int32_t*, size_t, int32_t);
+}SIMD_KERNELS;
+
+/**
+ * @brief Replaces the entries of @p k that have a vector version for the instruction set of the module. The other entries are kept,
+ * so each level starts from the table of the level below. Min/max reductions of a table only need at least one element.
+ * @param k Table to update.
+ * @return false if the module has been compiled without support for its instruction set.
+ */
+bool fillSimdKernelsSse2(SIMD_KERNELS* k);
+bool fillSimdKernelsAvx2(SIMD_KERNELS* k);
+bool fillSimdKernelsAvx512(SIMD_KERNELS* k);
+
+#endif // CSSIMD_INTERNAL_H_INCLUDED
@@ -0,0 +1,251 @@
+#ifndef CSSIMD_KERNELS_H_INCLUDED
+#define CSSIMD_KERNELS_H_INCLUDED
+
+#include "csSimdInternal.h"
+
+// Noyaux generiques ecrits une fois pour tous les jeux d'instructions. Chaque module les instancie avec ses propres types V :
+// T (type scalaire), R (registre), W (nombre de lignes), load, store, set1, add, sub, mul, madd (a*b+c), min, max,
+// reduceAdd, reduceMin, reduceMax.
+// Tout est dans un espace de noms anonyme : chaque module garde sa copie compilee avec ses options, sans conflit a l'edition de liens.
+// Pour la meme raison, ces noyaux n'appellent aucune fonction inline de la bibliotheque standard.
+
+namespace
+{
+
+// Nombre de registres accumulateurs : masque la latence des additions
+const size_t UNROLL = 4;
+
+inline int32_t mulWrap(int32_t a, int32_t b) { return (int32_t)((uint32_t)a*(uint32_t)b); }
+inline int32_t addWrap(int32_t a, int32_t b) { return (int32_t)((uint32_t)a + (uint32_t)b); }
+inline float mulWrap(float a, float b) { return a*b; }
+inline float addWrap(float a, float b) { return a + b; }
+inline double mulWrap(double a, double b) { return a*b; }
+inline double addWrap(double a, double b) { return a + b; }
+
+template<class V> typename V::T kSum(const typename V::T* x, size_t n)
+{
+  typedef typename V::R R;
+  R s[UNROLL];
+  for(size_t u=0; u<UNROLL; u++)
+    s[u] = V::set1(0);
+  size_t i = 0;
+  for(; i+UNROLL*V::W<=n; i+=UNROLL*V::W)
+    for(size_t u=0; u<UNROLL; u++)
+      s[u] = V::add(s[u], V::load(x + i + u*V::W));
+  for(; i+V::W<=n; i+=V::W)
+    s[0] = V::add(s[0], V::load(x + i));
+  typename V::T sum = V::reduceAdd(V::add(V::add(s[0], s[1]), V::add(s[2], s[3])));
+  for(; i<n; i++)
+    sum += x[i];
+  return sum;
+}
+
+template<class V> typename V::T kDot(const typename V::T* x, const typename V::T* y, size_t n)
+{
+  typedef typename V::R R;
+  R s[UNROLL];
+  for(size_t u=0; u<UNROLL; u++)
+    s[u] = V::set1(0);
+  size_t i = 0;
+  for(; i+UNROLL*V::W<=n; i+=UNROLL*V::W)
+    for(size_t u=0; u<UNROLL; u++)
+      s[u] = V::madd(V::load(x + i + u*V::W), V::load(y + i + u*V::W), s[u]);
+  for(; i+V::W<=n; i+=V::W)
+    s[0] = V::madd(V::load(x + i), V::load(y + i), s[0]);
+  typename V::T sum = V::reduceAdd(V::add(V::add(s[0], s[1]), V::add(s[2], s[3])));
+  for(; i<n; i++)
+    sum += x[i]*y[i];
+  return sum;
+}
+
+template<class V> typename V::T kSumSquares(const typename V::T* x, size_t n)
+{
+  return kDot<V>(x, x, n);
+}
+
+// Addition compensee d'un scalaire (Kahan)
+template<class T> inline void kahanAdd(T& sum, T& comp, T v)
+{
+  T y = v - comp;
+  T t = sum + y;
+  comp = (t - sum) - y;
+  sum = t;
+}
+
+template<class V> typename V::T kKahanSum(const typename V::T* x, size_t n)
+{
+  typedef typename V::T T;
+  typedef typename V::R R;
+  R s[UNROLL], c[UNROLL];
+  for(size_t u=0; u<UNROLL; u++)
+  {
+    s[u] = V::set1(0);
+    c[u] = V::set1(0);
+  }
+  size_t i = 0;
+  for(; i+UNROLL*V::W<=n; i+=UNROLL*V::W)
+  {
+    for(size_t u=0; u<UNROLL; u++)
+    {
+      R y = V::sub(V::load(x + i + u*V::W), c[u]);
+      R t = V::add(s[u], y);
+      c[u] = V::sub(V::sub(t, s[u]), y);
+      s[u] = t;
+    }
+  }
+  // Fusion des lignes : la valeur portee par une ligne est s - c
+  T sum = 0, comp = 0;
+  T ls[V::W], lc[V::W];
+  for(size_t u=0; u<UNROLL; u++)
+  {
+    V::store(ls, s[u]);
+    V::store(lc, c[u]);
+    for(size_t l=0; l<V::W; l++)
+    {
+      kahanAdd(sum, comp, ls[l]);
+      kahanAdd(sum, comp, -lc[l]);
+    }
+  }
+  for(; i<n; i++)
+    kahanAdd(sum, comp, x[i]);
+  return sum;
+}
+
+template<class V> typename V::T kMin(const typename V::T* x, size_t n)
+{
+  typedef typename V::R R;
+  R m[UNROLL];
+  for(size_t u=0; u<UNROLL; u++)
+    m[u] = V::set1(x[0]);
+  size_t i = 0;
+  for(; i+UNROLL*V::W<=n; i+=UNROLL*V::W)
+    for(size_t u=0; u<UNROLL; u++)
+      m[u] = V::min(m[u], V::load(x + i + u*V::W));
+  for(; i+V::W<=n; i+=V::W)
+    m[0] = V::min(m[0], V::load(x + i));
+  typename V::T r = V::reduceMin(V::min(V::min(m[0], m[1]), V::min(m[2], m[3])));
+  for(; i<n; i++)
+    if (x[i] < r) r = x[i];
+  return r;
+}
+
+template<class V> typename V::T kMax(const typename V::T* x, size_t n)
+{
+  typedef typename V::R R;
+  R m[UNROLL];
+  for(size_t u=0; u<UNROLL; u++)
+    m[u] = V::set1(x[0]);
+  size_t i = 0;
+  for(; i+UNROLL*V::W<=n; i+=UNROLL*V::W)
+    for(size_t u=0; u<UNROLL; u++)
+      m[u] = V::max(m[u], V::load(x + i + u*V::W));
+  for(; i+V::W<=n; i+=V::W)
+    m[0] = V::max(m[0], V::load(x + i));
+  typename V::T r = V::reduceMax(V::max(V::max(m[0], m[1]), V::max(m[2], m[3])));
+  for(; i<n; i++)
+    if (x[i] > r) r = x[i];
+  return r;
+}
+
+template<class V> void kAxpy(typename V::T a, const typename V::T* x, typename V::T* y, size_t n)
+{
+  typename V::R va = V::set1(a);
+  size_t i = 0;
+  for(; i+V::W<=n; i+=V::W)
+    V::store(y + i, V::madd(va, V::load(x + i), V::load(y + i)));
+  for(; i<n; i++)
+    y[i] = addWrap(mulWrap(a, x[i]), y[i]);
+}
+
+template<class V> void kScale(typename V::T* x, size_t n, typename V::T a)
+{
+  typename V::R va = V::set1(a);
+  size_t i = 0;
+  for(; i+V::W<=n; i+=V::W)
+    V::store(x + i, V::mul(va, V::load(x + i)));
+  for(; i<n; i++)
+    x[i] = mulWrap(x[i], a);
+}
+
+template<class V> void kFill(typename V::T* x, size_t n, typename V::T v)
+{
+  typename V::R vv = V::set1(v);
+  size_t i = 0;
+  for(; i+V::W<=n; i+=V::W)
+    V::store(x + i, vv);
+  for(; i<n; i++)
+    x[i] = v;
+}
+
+// Reductions generiques par passage en memoire, pour les jeux d'instructions sans reduction horizontale
+template<class V> typename V::T lanesAdd(typename V::R v)
+{
+  typename V::T l[V::W];
+  V::store(l, v);
+  typename V::T r = l[0];
+  for(size_t i=1; i<V::W; i++)
+    r = addWrap(r, l[i]);
+  return r;
+}
+
+template<class V> typename V::T lanesMin(typename V::R v)
+{
+  typename V::T l[V::W];
+  V::store(l, v);
+  typename V::T r = l[0];
+  for(size_t i=1; i<V::W; i++)
+    if (l[i] < r) r = l[i];
+  return r;
+}
+
+template<class V> typename V::T lanesMax(typename V::R v)
+{
+  typename V::T l[V::W];
+  V::store(l, v);
+  typename V::T r = l[0];
+  for(size_t i=1; i<V::W; i++)
+    if (l[i] > r) r = l[i];
+  return r;
+}
+
+// Noyaux flottants d'un jeu d'instructions (VD : double, VF : float)
+template<class VD, class VF> void fillFloatKernels(SIMD_KERNELS* k)
+{
+  k->sumD = kSum<VD>;
+  k->sumF = kSum<VF>;
+  k->kahanSumD = kKahanSum<VD>;
+  k->kahanSumF = kKahanSum<VF>;
+  k->sumSquaresD = kSumSquares<VD>;
+  k->sumSquaresF = kSumSquares<VF>;
+  k->dotD = kDot<VD>;
+  k->dotF = kDot<VF>;
+  k->minD = kMin<VD>;
+  k->minF = kMin<VF>;
+  k->maxD = kMax<VD>;
+  k->maxF = kMax<VF>;
+  k->axpyD = kAxpy<VD>;
+  k->axpyF = kAxpy<VF>;
+  k->scaleD = kScale<VD>;
+  k->scaleF = kScale<VF>;
+  k->fillD = kFill<VD>;
+  k->fillF = kFill<VF>;
+}
+
+// Noyaux int32 communs a tous les jeux d'instructions
+template<class VI> void fillIntKernels(SIMD_KERNELS* k)
+{
+  k->minI = kMin<VI>;
+  k->maxI = kMax<VI>;
+  k->fillI = kFill<VI>;
+}
+
+// Noyaux int32 qui demandent une multiplication 32 bits
+template<class VI> void fillIntMulKernels(SIMD_KERNELS* k)
+{
+  k->axpyI = kAxpy<VI>;
+  k->scaleI = kScale<VI>;
+}
+
+}
+
+#endif // CSSIMD_KERNELS_H_INCLUDED
@@ -0,0 +1,113 @@
+#include "csSimdKernels.h"
+
+// Noyaux SSE2 (registres de 128 bits). SSE2 n'a ni multiplication 32 bits ni min/max entiers :
+// min/max sont emules par comparaison, axpy/scale/dot int32 restent scalaires.
+
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+
+namespace
+{
+
+struct SSE2_D
+{
+  typedef double T;
+  typedef __m128d R;
+  static const size_t W = 2;
+  static R load(const T* p) { return _mm_loadu_pd(p); }
+  static void store(T* p, R v) { _mm_storeu_pd(p, v); }
+  static R set1(T v) { return _mm_set1_pd(v); }
+  static R add(R a, R b) { return _mm_add_pd(a, b); }
+  static R sub(R a, R b) { return _mm_sub_pd(a, b); }
+  static R mul(R a, R b) { return _mm_mul_pd(a, b); }
+  static R madd(R a, R b, R c) { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+  static R min(R a, R b) { return _mm_min_pd(a, b); }
+  static R max(R a, R b) { return _mm_max_pd(a, b); }
+  static T reduceAdd(R v) { return lanesAdd<SSE2_D>(v); }
+  static T reduceMin(R v) { return lanesMin<SSE2_D>(v); }
+  static T reduceMax(R v) { return lanesMax<SSE2_D>(v); }
+};
+
+struct SSE2_F
+{
+  typedef float T;
+  typedef __m128 R;
+  static const size_t W = 4;
+  static R load(const T* p) { return _mm_loadu_ps(p); }
+  static void store(T* p, R v) { _mm_storeu_ps(p, v); }
+  static R set1(T v) { return _mm_set1_ps(v); }
+  static R add(R a, R b) { return _mm_add_ps(a, b); }
+  static R sub(R a, R b) { return _mm_sub_ps(a, b); }
+  static R mul(R a, R b) { return _mm_mul_ps(a, b); }
+  static R madd(R a, R b, R c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+  static R min(R a, R b) { return _mm_min_ps(a, b); }
+  static R max(R a, R b) { return _mm_max_ps(a, b); }
+  static T reduceAdd(R v) { return lanesAdd<SSE2_F>(v); }
+  static T reduceMin(R v) { return lanesMin<SSE2_F>(v); }
+  static T reduceMax(R v) { return lanesMax<SSE2_F>(v); }
+};
+
+struct SSE2_I
+{
+  typedef int32_t T;
+  typedef __m128i R;
+  static const size_t W = 4;
+  static R load(const T* p) { return _mm_loadu_si128((const __m128i*)p); }
+  static void store(T* p, R v) { _mm_storeu_si128((__m128i*)p, v); }
+  static R set1(T v) { return _mm_set1_epi32(v); }
+  static R add(R a, R b) { return _mm_add_epi32(a, b); }
+  static R sub(R a, R b) { return _mm_sub_epi32(a, b); }
+  static R min(R a, R b)
+  {
+    R gt = _mm_cmpgt_epi32(a, b);
+    return _mm_or_si128(_mm_and_si128(gt, b), _mm_andnot_si128(gt, a));
+  }
+  static R max(R a, R b)
+  {
+    R gt = _mm_cmpgt_epi32(a, b);
+    return _mm_or_si128(_mm_and_si128(gt, a), _mm_andnot_si128(gt, b));
+  }
+  static T reduceAdd(R v) { return lanesAdd<SSE2_I>(v); }
+  static T reduceMin(R v) { return lanesMin<SSE2_I>(v); }
+  static T reduceMax(R v) { return lanesMax<SSE2_I>(v); }
+};
+
+// Somme int32 sur des accumulateurs 64 bits : extension de signe par entrelacement avec le masque de signe
+int64_t sumInt(const int32_t* x, size_t n)
+{
+  __m128i s0 = _mm_setzero_si128(), s1 = _mm_setzero_si128();
+  size_t i = 0;
+  for(; i+4<=n; i+=4)
+  {
+    __m128i v = _mm_loadu_si128((const __m128i*)(x + i));
+    __m128i sign = _mm_srai_epi32(v, 31);
+    s0 = _mm_add_epi64(s0, _mm_unpacklo_epi32(v, sign));
+    s1 = _mm_add_epi64(s1, _mm_unpackhi_epi32(v, sign));
+  }
+  int64_t l[2];
+  _mm_storeu_si128((__m128i*)l, _mm_add_epi64(s0, s1));
+  int64_t s = l[0] + l[1];
+  for(; i<n; i++)
+    s += x[i];
+  return s;
+}
+
+}
+
+bool fillSimdKernelsSse2(SIMD_KERNELS* k)
+{
+  fillFloatKernels<SSE2_D, SSE2_F>(k);
+  fillIntKernels<SSE2_I>(k);
+  k->sumI = sumInt;
+  return true;
+}
+
+#else
+
+bool fillSimdKernelsSse2(SIMD_KERNELS* k)
+{
+  (void)k;
+  return false;
+}
+
+#endif
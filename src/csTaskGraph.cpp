@@ -0,0 +1,253 @@
+#include <iostream>
+#include <memory>
+#include <atomic>
+#include "csTaskGraph.h"
+#include "csParallel.h"
+#include "csParallelInternal.h"
+
+using namespace std;
+
+static const size_t NO_BLOCK = (size_t)-1;
+
+// Etat d'une execution du graphe ; les blocs sont numerotes globalement, noeud apres noeud
+typedef struct
+{
+  CSTHREAD_POOL* pool;
+  CSTHREAD_POOL::TASK_GROUP* group;
+  vector<size_t> offset;
+  vector<size_t> nodeOf;
+  vector<CSTHREAD_POOL::TASK_FUNC> funcs;
+  vector<void*> ctxs;
+  vector<vector<size_t>> taskNext;
+  vector<vector<size_t>> blockNext;
+  unique_ptr<atomic<size_t>[]> waiting;
+  unique_ptr<atomic<size_t>[]> nodeRemaining;
+  atomic<size_t> remaining;
+}GRAPH_RUN;
+
+static void runGraphBlock(void* ctx, size_t g);
+
+static void releaseBlock(GRAPH_RUN* run, size_t g, size_t& next)
+{
+  if (run->waiting[g].fetch_sub(1, memory_order_acq_rel) != 1)
+    return;
+
+  // Le premier bloc libere est execute sur place : ses donnees sont encore dans le cache
+  if (next == NO_BLOCK)
+    next = g;
+  else
+    run->pool->submit(g, g+1, runGraphBlock, run, 0);
+}
+
+static void runGraphBlock(void* ctx, size_t g)
+{
+  GRAPH_RUN* run = (GRAPH_RUN*)ctx;
+
+  while (g != NO_BLOCK)
+  {
+    size_t node = run->nodeOf[g];
+    size_t block = g - run->offset[node];
+    run->funcs[node](run->ctxs[node], block);
+
+    size_t next = NO_BLOCK;
+    for(size_t succ : run->blockNext[node])
+    {
+      releaseBlock(run, run->offset[succ] + block, next);
+    }
+    if (run->nodeRemaining[node].fetch_sub(1, memory_order_acq_rel) == 1)
+    {
+      for(size_t succ : run->taskNext[node])
+      {
+        for(size_t j=run->offset[succ]; j<run->offset[succ+1]; j++)
+          releaseBlock(run, j, next);
+      }
+    }
+
+    if (run->remaining.fetch_sub(1, memory_order_acq_rel) == 1)
+    {
+      run->pool->complete(run->group);
+      delete run;
+      return;
+    }
+    g = next;
+  }
+}
+
+CSTASK_GRAPH::CSTASK_GRAPH()
+{
+}
+
+size_t CSTASK_GRAPH::findTask(size_t idf)
+{
+  size_t n = tasks.size();
+  for(size_t i=0; i<n; i++)
+  {
+    if (tasks[i] == idf)
+      return i;
+  }
+  return NO_BLOCK;
+}
+
+void CSTASK_GRAPH::addTask(size_t idf)
+{
+  if (!csParallelTask::isRegistered(idf))
+  {
+    cout<<"invalid function id !\n";
+    return;
+  }
+  if (findTask(idf) == NO_BLOCK)
+    tasks.push_back(idf);
+}
+
+void CSTASK_GRAPH::addDependency(size_t idfBefore, size_t idfAfter, int mode)
+{
+  if (idfBefore == idfAfter)
+  {
+    cout<<"invalid dependency !\n";
+    return;
+  }
+  if (!csParallelTask::isRegistered(idfBefore) || !csParallelTask::isRegistered(idfAfter))
+  {
+    cout<<"invalid function id !\n";
+    return;
+  }
+  addTask(idfBefore);
+  addTask(idfAfter);
+  dependencies.push_back({idfBefore, idfAfter, mode});
+}
+
+void CSTASK_GRAPH::clear()
+{
+  tasks.clear();
+  dependencies.clear();
+}
+
+size_t CSTASK_GRAPH::getTaskNumber()
+{
+  return tasks.size();
+}
+
+bool CSTASK_GRAPH::sortTasks(vector<size_t>& order)
+{
+  size_t nNodes = tasks.size();
+  vector<size_t> nPred(nNodes, 0);
+  for(DEPENDENCY& d : dependencies)
+  {
+    nPred[findTask(d.after)]++;
+  }
+
+  order.clear();
+  for(size_t i=0; i<nNodes; i++)
+  {
+    if (nPred[i] == 0)
+      order.push_back(i);
+  }
+  for(size_t k=0; k<order.size(); k++)
+  {
+    size_t idf = tasks[order[k]];
+    for(DEPENDENCY& d : dependencies)
+    {
+      if (d.before == idf && --nPred[findTask(d.after)] == 0)
+        order.push_back(findTask(d.after));
+    }
+  }
+  return order.size() == nNodes;
+}
+
+CSTASK_FUTURE CSTASK_GRAPH::executeAsync()
+{
+  vector<size_t> order;
+  if (!sortTasks(order))
+  {
+    cout<<"cyclic task graph !\n";
+    return CSTASK_FUTURE();
+  }
+
+  size_t nNodes = tasks.size();
+  if (nNodes == 0)
+    return CSTASK_FUTURE();
+  for(size_t i=0; i<nNodes; i++)
+  {
+    if (!csParallelTask::isRegistered(tasks[i]))
+    {
+      cout<<"invalid function id !\n";
+      return CSTASK_FUTURE();
+    }
+  }
+
+  GRAPH_RUN* run = new GRAPH_RUN;
+  run->pool = csParallelTask::getThreadPool();
+  run->offset.resize(nNodes+1, 0);
+  run->funcs.resize(nNodes);
+  run->ctxs.resize(nNodes);
+  run->taskNext.resize(nNodes);
+  run->blockNext.resize(nNodes);
+
+  for(size_t i=0; i<nNodes; i++)
+  {
+    run->offset[i+1] = run->offset[i] + csParallelTask::getBlockNumber(tasks[i]);
+  }
+  size_t nTotal = run->offset[nNodes];
+  run->nodeOf.resize(nTotal);
+  run->waiting.reset(new atomic<size_t>[nTotal]);
+  run->nodeRemaining.reset(new atomic<size_t>[nNodes]);
+  run->remaining = nTotal;
+
+  for(size_t i=0; i<nNodes; i++)
+  {
+    run->nodeRemaining[i] = run->offset[i+1] - run->offset[i];
+    for(size_t g=run->offset[i]; g<run->offset[i+1]; g++)
+    {
+      run->nodeOf[g] = i;
+      run->waiting[g] = 0;
+    }
+  }
+
+  for(DEPENDENCY& d : dependencies)
+  {
+    size_t a = findTask(d.before);
+    size_t b = findTask(d.after);
+    size_t nA = run->offset[a+1] - run->offset[a];
+    size_t nB = run->offset[b+1] - run->offset[b];
+
+    bool blockwise = d.mode == CSDEPENDENCY_BLOCK && nA == nB
+      && csParallelTask::getSchedulingMode(d.before) == CSSCHEDULE_STATIC
+      && csParallelTask::getSchedulingMode(d.after) == CSSCHEDULE_STATIC;
+
+    if (blockwise)
+      run->blockNext[a].push_back(b);
+    else
+      run->taskNext[a].push_back(b);
+
+    for(size_t g=run->offset[b]; g<run->offset[b+1]; g++)
+      run->waiting[g]++;
+  }
+
+  for(size_t i=0; i<nNodes; i++)
+  {
+    csParallelTask::prepareBlocks(tasks[i], &run->funcs[i], &run->ctxs[i]);
+  }
+
+  // Les blocs sans dependance sont releves avant la premiere soumission :
+  // ensuite les compteurs evoluent en parallele
+  vector<size_t> ready;
+  for(size_t g=0; g<nTotal; g++)
+  {
+    if (run->waiting[g] == 0)
+      ready.push_back(g);
+  }
+
+  run->group = CSTHREAD_POOL::createGroup(1);
+  CSTASK_FUTURE future(run->pool, run->group);
+  CSTHREAD_POOL* pool = run->pool;
+  for(size_t g : ready)
+  {
+    pool->submit(g, g+1, runGraphBlock, run, 0);
+  }
+  return future;
+}
+
+void CSTASK_GRAPH::execute()
+{
+  executeAsync().wait();
+}
@@ -0,0 +1,454 @@
+#include <chrono>
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+#include "csThreadPool.h"
+#include "csAffinity.h"
+#include "csTraceInternal.h"
+
+// Nombre d'iterations d'attente active avant de s'endormir sur la condition
+static const size_t SPIN_COUNT = 2000;
+
+// Duree maximale d'une attente sur la condition pendant qu'un worker aide a executer les taches
+static const size_t HELP_SLEEP_US = 50;
+
+static thread_local bool IS_WORKER = false;
+// Pool et index du worker courant, pour qu'une attente imbriquee execute les taches de son propre pool
+static thread_local CSTHREAD_POOL* WORKER_POOL = 0;
+static thread_local size_t WORKER_INDEX = 0;
+
+CSTHREAD_POOL::CSTHREAD_POOL(size_t nWorkers)
+{
+    queued = 0;
+    sleepers = 0;
+    startedWorkers = 0;
+    stopping = false;
+    if (nWorkers > 0)
+        start(nWorkers);
+}
+
+CSTHREAD_POOL::~CSTHREAD_POOL()
+{
+    stop();
+}
+
+void CSTHREAD_POOL::start(size_t nWorkers)
+{
+    stop();
+    stopping = false;
+    localQueues.assign(nWorkers, std::deque<TASK>());
+    systemIds.assign(nWorkers, 0);
+    startedWorkers = 0;
+    for(size_t i=0; i<nWorkers; i++)
+    {
+        workers.push_back(std::thread(&CSTHREAD_POOL::workerLoop, this, i));
+    }
+    applyAffinity();
+
+    // Attendre que chaque worker ait publie son identifiant systeme
+    for(;;)
+    {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            if (startedWorkers == nWorkers)
+                break;
+        }
+        std::this_thread::yield();
+    }
+}
+
+void CSTHREAD_POOL::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueCv.notify_all();
+
+    size_t n = workers.size();
+    for(size_t i=0; i<n; i++)
+    {
+        workers[i].join();
+    }
+    workers.clear();
+    systemIds.clear();
+}
+
+size_t CSTHREAD_POOL::getWorkerNumber()
+{
+    return workers.size();
+}
+
+bool CSTHREAD_POOL::isWorkerThread()
+{
+    return IS_WORKER;
+}
+
+size_t CSTHREAD_POOL::getWorkerIndex()
+{
+    return IS_WORKER ? WORKER_INDEX : NO_WORKER;
+}
+
+size_t CSTHREAD_POOL::getWorkerSystemId(size_t worker)
+{
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return worker < systemIds.size() ? systemIds[worker] : 0;
+}
+
+void CSTHREAD_POOL::setAffinity(const std::vector<size_t>& cpus)
+{
+    affinity = cpus;
+    if (affinity.empty())
+    {
+        // Retour a l'ensemble des CPU autorises
+        std::vector<size_t> all = csParallelTask::getAvailableCpus();
+        for(size_t w=0; w<workers.size(); w++)
+        {
+            csParallelTask::pinThread(workers[w].native_handle(), all);
+        }
+    }
+    applyAffinity();
+}
+
+void CSTHREAD_POOL::applyAffinity()
+{
+    if (affinity.empty())
+        return;
+    for(size_t w=0; w<workers.size(); w++)
+    {
+        csParallelTask::pinThread(workers[w].native_handle(), affinity[w % affinity.size()]);
+    }
+}
+
+size_t CSTHREAD_POOL::getWorkerCpu(size_t worker)
+{
+    if (affinity.empty())
+        return NO_CPU;
+    return affinity[worker % affinity.size()];
+}
+
+size_t CSTHREAD_POOL::getWorkerOnCpu(size_t cpu)
+{
+    size_t n = std::min(workers.size(), affinity.size());
+    for(size_t w=0; w<n; w++)
+    {
+        if (affinity[w] == cpu)
+            return w;
+    }
+    return NO_CPU;
+}
+
+void CSTHREAD_POOL::submitTo(size_t worker, size_t index, TASK_FUNC func, void* ctx, TASK_GROUP* group)
+{
+    if (workers.empty())
+    {
+        submit(index, index+1, func, ctx, group);
+        return;
+    }
+
+    bool wake;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        localQueues[worker % workers.size()].push_back({func, ctx, index, group});
+        queued.fetch_add(1, std::memory_order_release);
+        wake = sleepers > 0;
+    }
+
+    // Le reveil ne peut pas viser un worker precis
+    if (wake)
+        queueCv.notify_all();
+}
+
+void CSTHREAD_POOL::submit(size_t first, size_t last, TASK_FUNC func, void* ctx, TASK_GROUP* group)
+{
+    if (first >= last)
+        return;
+
+    bool wake;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        for(size_t i=first; i<last; i++)
+        {
+            queue.push_back({func, ctx, i, group});
+        }
+        queued.fetch_add(last-first, std::memory_order_release);
+        wake = sleepers > 0;
+    }
+
+    if (wake)
+    {
+        if (last-first == 1)
+            queueCv.notify_one();
+        else
+            queueCv.notify_all();
+    }
+}
+
+void CSTHREAD_POOL::wait(TASK_GROUP* group)
+{
+    if (WORKER_POOL == this)
+    {
+        help(group);
+        return;
+    }
+
+    for(size_t s=0; s<SPIN_COUNT; s++)
+    {
+        if (group->pending.load(std::memory_order_acquire) == 0)
+            return;
+        std::this_thread::yield();
+    }
+
+    std::unique_lock<std::mutex> lock(doneMutex);
+    doneCv.wait(lock, [group]{ return group->pending.load(std::memory_order_acquire) == 0; });
+}
+
+void CSTHREAD_POOL::help(TASK_GROUP* group)
+{
+    // Le worker ne bloque pas : il execute les taches en attente (celles du groupe ou d'autres) jusqu'a la fin du groupe
+    TASK task;
+    size_t idle = 0;
+    while (group->pending.load(std::memory_order_acquire) > 0)
+    {
+        if (queued.load(std::memory_order_acquire) > 0 && pop(WORKER_INDEX, task))
+        {
+            runTask(task);
+            idle = 0;
+        }
+        else if (++idle < SPIN_COUNT)
+            std::this_thread::yield();
+        else
+        {
+            // Les taches du groupe sont en cours sur d'autres workers
+            std::unique_lock<std::mutex> lock(doneMutex);
+            doneCv.wait_for(lock, std::chrono::microseconds(HELP_SLEEP_US),
+                [group]{ return group->pending.load(std::memory_order_acquire) == 0; });
+            idle = 0;
+        }
+    }
+}
+
+bool CSTHREAD_POOL::wait(TASK_GROUP* group, size_t timeoutNs)
+{
+    std::unique_lock<std::mutex> lock(doneMutex);
+    return doneCv.wait_for(lock, std::chrono::nanoseconds(timeoutNs),
+        [group]{ return group->pending.load(std::memory_order_acquire) == 0; });
+}
+
+CSTHREAD_POOL::TASK_GROUP* CSTHREAD_POOL::createGroup(size_t pending)
+{
+    TASK_GROUP* group = new TASK_GROUP;
+    group->pending = pending;
+    // Une reference pour le proprietaire, une pour la fin des taches
+    group->refs = pending > 0 ? 2 : 1;
+    return group;
+}
+
+void CSTHREAD_POOL::retainGroup(TASK_GROUP* group)
+{
+    group->refs.fetch_add(1, std::memory_order_relaxed);
+}
+
+void CSTHREAD_POOL::releaseGroup(TASK_GROUP* group)
+{
+    if (group->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        delete group;
+}
+
+void CSTHREAD_POOL::run(size_t nTasks, TASK_FUNC func, void* ctx)
+{
+    if (nTasks == 0)
+        return;
+
+    TASK_GROUP group;
+    group.pending = nTasks-1;
+    group.refs = 0;
+    submit(1, nTasks, func, ctx, &group);
+
+    func(ctx, 0);
+
+    if (nTasks > 1)
+        wait(&group);
+}
+
+bool CSTHREAD_POOL::pop(size_t worker, TASK& task)
+{
+    std::lock_guard<std::mutex> lock(queueMutex);
+    std::deque<TASK>& local = localQueues[worker];
+    if (!local.empty())
+    {
+        task = local.front();
+        local.pop_front();
+    }
+    else if (!queue.empty())
+    {
+        task = queue.front();
+        queue.pop_front();
+    }
+    else
+        return false;
+
+    queued.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+void CSTHREAD_POOL::runTask(TASK& task)
+{
+    task.func(task.ctx, task.index);
+
+    if (task.group)
+        complete(task.group);
+}
+
+void CSTHREAD_POOL::complete(TASK_GROUP* group)
+{
+    // Lu avant la decrementation : un groupe sur la pile peut disparaitre juste apres
+    bool counted = group->refs.load(std::memory_order_relaxed) > 0;
+    if (group->pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        {
+            // Le verrou evite de perdre le reveil d'un thread qui s'apprete a attendre
+            std::lock_guard<std::mutex> lock(doneMutex);
+            doneCv.notify_all();
+        }
+        if (counted)
+            releaseGroup(group);
+    }
+}
+
+void CSTHREAD_POOL::workerLoop(size_t worker)
+{
+    IS_WORKER = true;
+    WORKER_POOL = this;
+    WORKER_INDEX = worker;
+    TASK task;
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+#ifdef __linux__
+        systemIds[worker] = (size_t)syscall(SYS_gettid);
+#endif
+        startedWorkers++;
+    }
+
+    for(;;)
+    {
+        if (pop(worker, task))
+        {
+            runTask(task);
+            continue;
+        }
+
+        bool found = false;
+        for(size_t s=0; s<SPIN_COUNT && !found; s++)
+        {
+            if (queued.load(std::memory_order_acquire) > 0)
+                found = pop(worker, task);
+            else
+                std::this_thread::yield();
+        }
+        if (found)
+        {
+            runTask(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(queueMutex);
+        sleepers++;
+        std::deque<TASK>& local = localQueues[worker];
+        queueCv.wait(lock, [this, &local]{ return stopping || !queue.empty() || !local.empty(); });
+        sleepers--;
+        if (stopping && queue.empty() && local.empty())
+            return;
+        lock.unlock();
+        if (csParallelTask::isTracing())
+        {
+            static const uint32_t wakeName = csParallelTask::traceName("wake");
+            csParallelTask::traceEvent('i', CSTRACE_WAKE, wakeName, worker);
+        }
+    }
+}
+
+CSTASK_FUTURE::CSTASK_FUTURE()
+{
+    pool = 0;
+    group = 0;
+}
+
+CSTASK_FUTURE::CSTASK_FUTURE(CSTHREAD_POOL* _pool, CSTHREAD_POOL::TASK_GROUP* _group)
+{
+    pool = _pool;
+    group = _group;
+}
+
+CSTASK_FUTURE::CSTASK_FUTURE(const CSTASK_FUTURE& future)
+{
+    pool = future.pool;
+    group = future.group;
+    if (group)
+        CSTHREAD_POOL::retainGroup(group);
+}
+
+CSTASK_FUTURE& CSTASK_FUTURE::operator=(const CSTASK_FUTURE& future)
+{
+    if (future.group)
+        CSTHREAD_POOL::retainGroup(future.group);
+    if (group)
+        CSTHREAD_POOL::releaseGroup(group);
+    pool = future.pool;
+    group = future.group;
+    return *this;
+}
+
+CSTASK_FUTURE::~CSTASK_FUTURE()
+{
+    if (group)
+        CSTHREAD_POOL::releaseGroup(group);
+}
+
+void CSTASK_FUTURE::wait()
+{
+    if (group)
+        pool->wait(group);
+}
+
+bool CSTASK_FUTURE::waitFor(size_t timeout, int unit)
+{
+    if (!group)
+        return true;
+
+    size_t ns;
+    switch (unit)
+    {
+    case CSTIME_UNIT_HOUR:
+        ns = timeout * 3600000000000ull;
+        break;
+    case CSTIME_UNIT_MINUTE:
+        ns = timeout * 60000000000ull;
+        break;
+    case CSTIME_UNIT_SECOND:
+        ns = timeout * 1000000000ull;
+        break;
+    case CSTIME_UNIT_MICROSECOND:
+        ns = timeout * 1000ull;
+        break;
+    case CSTIME_UNIT_NANOSECOND:
+        ns = timeout;
+        break;
+    default:
+        ns = timeout * 1000000ull;
+        break;
+    }
+    return pool->wait(group, ns);
+}
+
+bool CSTASK_FUTURE::poll()
+{
+    return !group || group->pending.load(std::memory_order_acquire) == 0;
+}
+
+bool CSTASK_FUTURE::isValid()
+{
+    return group != 0;
+}
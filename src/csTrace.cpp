@@ -0,0 +1,245 @@
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "csThreadPool.h"
+#include "csJsonInternal.h"
+#include "csTraceInternal.h"
+
+using namespace std;
+
+typedef struct
+{
+  uint64_t time;
+  uint64_t arg;
+  uint32_t name;
+  uint8_t kind;
+  char phase;
+}TRACE_EVENT;
+
+// Tableau circulaire d'evenements : un seul ecrivain. clearTrace() avance start au lieu de remettre head a 0,
+// pour ne jamais revenir en arriere sous un ecrivain en cours
+typedef struct
+{
+  vector<TRACE_EVENT> events;
+  size_t mask;
+  atomic<size_t> head;
+  atomic<size_t> start;
+}TRACE_BUFFER;
+
+// Tampon d'un thread. Un changement de taille publie un nouveau tableau ; l'ancien n'est jamais libere, car un ecrivain
+// peut encore le tenir. Les tampons non plus : le pointeur garde par chaque thread reste valide
+typedef struct
+{
+  atomic<TRACE_BUFFER*> buffer;
+  size_t tid;
+  size_t worker;
+}TRACE_RING;
+
+// Cache par thread des noms deja internes, indexe par l'adresse de la chaine : les appels repetes avec la meme chaine
+// ne prennent ni verrou ni recherche dans la table. La copie detecte une chaine modifiee a la meme adresse
+typedef struct
+{
+  const char* ptr;
+  string copy;
+  uint32_t index;
+}NAME_CACHE_ENTRY;
+
+static const size_t NAME_CACHE_SIZE = 64;
+
+atomic<bool> csParallelTask::TRACE_ENABLED(false);
+
+static mutex TRACE_MUTEX;
+static vector<TRACE_RING*> RINGS;
+static vector<string> NAMES;
+static unordered_map<string, uint32_t> NAME_INDEX;
+// Taille des nouveaux tampons, lue par les threads qui tracent pour la premiere fois
+static atomic<size_t> CAPACITY(CSTRACE_BUFFER_SIZE);
+
+static int64_t nowNs()
+{
+  return (int64_t)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Origine des temps en ns, changee par setTracing() et clearTrace() pendant que les workers la lisent
+static atomic<int64_t> EPOCH(nowNs());
+
+static TRACE_BUFFER* newBuffer(size_t capacity)
+{
+  TRACE_BUFFER* buffer = new TRACE_BUFFER;
+  buffer->events.resize(capacity);
+  buffer->mask = capacity - 1;
+  buffer->head = 0;
+  buffer->start = 0;
+  return buffer;
+}
+
+static size_t roundCapacity(size_t n)
+{
+  size_t c = 1;
+  while (c < n)
+    c <<= 1;
+  return c;
+}
+
+static TRACE_RING* localRing()
+{
+  static thread_local TRACE_RING* ring = 0;
+  if (!ring)
+  {
+    lock_guard<mutex> lock(TRACE_MUTEX);
+    ring = new TRACE_RING;
+    ring->buffer = newBuffer(CAPACITY.load());
+    ring->tid = RINGS.size() + 1;
+    ring->worker = CSTHREAD_POOL::getWorkerIndex();
+    RINGS.push_back(ring);
+  }
+  return ring;
+}
+
+uint32_t csParallelTask::traceName(const char* name)
+{
+  lock_guard<mutex> lock(TRACE_MUTEX);
+  string key = name ? name : "";
+  auto it = NAME_INDEX.find(key);
+  if (it != NAME_INDEX.end())
+    return it->second;
+  uint32_t index = (uint32_t)NAMES.size();
+  NAMES.push_back(key);
+  NAME_INDEX.emplace(key, index);
+  return index;
+}
+
+static uint32_t cachedName(const char* name)
+{
+  static thread_local NAME_CACHE_ENTRY cache[NAME_CACHE_SIZE];
+  if (!name)
+    name = "";
+  NAME_CACHE_ENTRY& c = cache[((uintptr_t)name >> 3) & (NAME_CACHE_SIZE - 1)];
+  if (c.ptr != name || c.copy != name)
+  {
+    c.index = csParallelTask::traceName(name);
+    c.ptr = name;
+    c.copy = name;
+  }
+  return c.index;
+}
+
+void csParallelTask::traceEvent(char phase, uint8_t kind, uint32_t name, uint64_t arg)
+{
+  TRACE_BUFFER* buffer = localRing()->buffer.load(memory_order_acquire);
+  size_t h = buffer->head.load(memory_order_relaxed);
+  TRACE_EVENT& e = buffer->events[h & buffer->mask];
+  int64_t time = nowNs() - EPOCH.load(memory_order_relaxed);
+  e.time = time > 0 ? (uint64_t)time : 0;
+  e.arg = arg;
+  e.name = name;
+  e.kind = kind;
+  e.phase = phase;
+  buffer->head.store(h + 1, memory_order_release);
+}
+
+void CS_PARALLEL_TASK_API csParallelTask::setTracing(bool enable, size_t eventsPerThread)
+{
+  if (enable)
+  {
+    size_t capacity = roundCapacity(eventsPerThread > 0 ? eventsPerThread : 1);
+    lock_guard<mutex> lock(TRACE_MUTEX);
+    if (capacity != CAPACITY)
+    {
+      CAPACITY = capacity;
+      for(TRACE_RING* ring : RINGS)
+        ring->buffer.store(newBuffer(capacity), memory_order_release);
+    }
+    if (!TRACE_ENABLED)
+      EPOCH = nowNs();
+  }
+  TRACE_ENABLED = enable;
+}
+
+bool CS_PARALLEL_TASK_API csParallelTask::getTracing()
+{
+  return isTracing();
+}
+
+void CS_PARALLEL_TASK_API csParallelTask::clearTrace()
+{
+  lock_guard<mutex> lock(TRACE_MUTEX);
+  for(TRACE_RING* ring : RINGS)
+  {
+    TRACE_BUFFER* buffer = ring->buffer.load(memory_order_acquire);
+    buffer->start = buffer->head.load(memory_order_acquire);
+  }
+  EPOCH = nowNs();
+}
+
+bool CS_PARALLEL_TASK_API csParallelTask::dumpTrace(const char* path)
+{
+  ofstream out(path ? path : "");
+  if (!out.is_open())
+  {
+    cout<<"cannot write trace file !\n";
+    return false;
+  }
+  static const char* categories[] = {"execute", "block", "launch", "wake", "steal", "user"};
+  static const char* argNames[] = {"blocks", "block", "blocks", 0, "victim", 0};
+
+  lock_guard<mutex> lock(TRACE_MUTEX);
+  out<<"{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+  out<<"{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"csParallelTask\"}}";
+  out<<fixed<<setprecision(3);
+  for(TRACE_RING* ring : RINGS)
+  {
+    string thread = ring->worker == CSTHREAD_POOL::NO_WORKER ? "thread " + to_string(ring->tid) : "worker " + to_string(ring->worker);
+    out<<",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"<<ring->tid<<",\"args\":{\"name\":";
+    writeJsonString(out, thread);
+    out<<"}}";
+
+    TRACE_BUFFER* buffer = ring->buffer.load(memory_order_acquire);
+    size_t head = buffer->head.load(memory_order_acquire);
+    size_t n = min(head - min(head, buffer->start.load()), buffer->events.size());
+    // Une fin dont le debut a ete ecrase par le tampon circulaire est ignoree
+    size_t depth = 0;
+    for(size_t k=head-n; k<head; k++)
+    {
+      const TRACE_EVENT& e = buffer->events[k & buffer->mask];
+      if (e.phase == 'E' && depth == 0)
+        continue;
+      depth += e.phase == 'B' ? 1 : e.phase == 'E' ? -1 : 0;
+
+      out<<",\n{\"name\":";
+      writeJsonString(out, e.name < NAMES.size() ? NAMES[e.name] : string());
+      out<<",\"cat\":\""<<categories[e.kind]<<"\",\"ph\":\""<<e.phase<<"\",\"ts\":"<<e.time/1000.0
+         <<",\"pid\":1,\"tid\":"<<ring->tid;
+      if (e.phase == 'i')
+        out<<",\"s\":\"t\"";
+      if (e.phase != 'E' && argNames[e.kind])
+        out<<",\"args\":{\""<<argNames[e.kind]<<"\":"<<e.arg<<"}";
+      out<<"}";
+    }
+  }
+  out<<"\n]}\n";
+  return out.good();
+}
+
+void CS_PARALLEL_TASK_API csParallelTask::traceBegin(const char* name)
+{
+  if (isTracing())
+    traceEvent('B', CSTRACE_USER, cachedName(name), 0);
+}
+
+void CS_PARALLEL_TASK_API csParallelTask::traceEnd(const char* name)
+{
+  if (isTracing())
+    traceEvent('E', CSTRACE_USER, cachedName(name), 0);
+}
+
+void CS_PARALLEL_TASK_API csParallelTask::traceMark(const char* name)
+{
+  if (isTracing())
+    traceEvent('i', CSTRACE_USER, cachedName(name), 0);
+}
@@ -0,0 +1,45 @@
+#ifndef CSTRACE_INTERNAL_H_INCLUDED
+#define CSTRACE_INTERNAL_H_INCLUDED
+
+#include <atomic>
+#include <cstdint>
+#include "csTrace.h"
+
+// Enregistrement des evenements de trace, partage entre les modules de la bibliotheque
+
+#define CSTRACE_EXECUTE   0
+#define CSTRACE_BLOCK     1
+#define CSTRACE_LAUNCH    2
+#define CSTRACE_WAKE      3
+#define CSTRACE_STEAL     4
+#define CSTRACE_USER      5
+
+namespace csParallelTask
+{
+
+extern std::atomic<bool> TRACE_ENABLED;
+
+inline bool isTracing()
+{
+  return TRACE_ENABLED.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Returns the index of @p name in the table of trace names, adding it if needed. The table is never shrunk,
+ * so the events keep a valid name after the function is unregistered.
+ * @param name Name to intern.
+ * @return Index of the name.
+ */
+uint32_t traceName(const char* name);
+/**
+ * @brief Appends an event to the ring buffer of the calling thread.
+ * @param phase Chrome trace phase: 'B' (begin), 'E' (end) or 'i' (instant).
+ * @param kind One of the CSTRACE_* kinds.
+ * @param name Index returned by traceName().
+ * @param arg Block index for blocks, block number for executions, victim block for steals.
+ */
+void traceEvent(char phase, uint8_t kind, uint32_t name, uint64_t arg);
+
+}
+
+#endif // CSTRACE_INTERNAL_H_INCLUDED
@@ -0,0 +1,247 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <map>
+#include <cstdlib>
+#include "csTuner.h"
+#include "csParallel.h"
+#include "csParallelInternal.h"
+
+using namespace std;
+
+// Profil : meilleure configuration par nom de fonction et tranche de taille
+static map<pair<string, size_t>, CSTUNE_ENTRY> PROFILE;
+
+static bool readProfile(const char* path)
+{
+  ifstream file(path ? path : "");
+  if (!file.is_open())
+  {
+    cout<<"cannot open tuning profile !\n";
+    return false;
+  }
+  string line;
+  while (getline(file, line))
+  {
+    if (line.empty() || line[0] == '#')
+      continue;
+    // Le nom est le reste de la ligne : il peut contenir des espaces
+    istringstream in(line);
+    CSTUNE_ENTRY e;
+    if (!(in>>e.sizeBucket>>e.nBlocks>>e.schedule>>e.chunkSize>>e.time) || e.nBlocks == 0
+        || e.schedule < CSSCHEDULE_STATIC || e.schedule > CSSCHEDULE_GUIDED)
+    {
+      cout<<"invalid tuning profile line !\n";
+      continue;
+    }
+    getline(in>>ws, e.name);
+    PROFILE[{e.name, e.sizeBucket}] = e;
+  }
+  return true;
+}
+
+static bool loadEnvironmentProfile()
+{
+  const char* path = getenv(CSTUNE_PROFILE_ENV);
+  if (path && *path)
+  {
+    // Le fichier n'existe pas encore avant le premier reglage
+    ifstream file(path);
+    if (file.good())
+      readProfile(path);
+  }
+  return true;
+}
+
+// Profil designe par la variable d'environnement, lu une seule fois avant tout autre acces au profil :
+// les chargements explicites passent apres et le completent
+static bool initTuning()
+{
+  static const bool init = loadEnvironmentProfile();
+  return init;
+}
+
+// Lecture au chargement de la bibliotheque, avant le premier enregistrement
+static const bool TUNING_INIT = initTuning();
+
+size_t CS_PARALLEL_TASK_API csParallelTask::getSizeBucket(size_t workSize)
+{
+  size_t bucket = 0;
+  while (workSize > 1)
+  {
+    workSize >>= 1;
+    bucket++;
+  }
+  return bucket;
+}
+
+static const CSTUNE_ENTRY* findEntry(size_t idf)
+{
+  auto it = PROFILE.find({csParallelTask::getFunctionName(idf), csParallelTask::getSizeBucket(csParallelTask::getWorkSize(idf))});
+  return it != PROFILE.end() ? &it->second : 0;
+}
+
+static bool isTiled(size_t idf)
+{
+  CSPARGS::TILE tile = csParallelTask::getArgs(idf, 0).getTile();
+  return tile.y.first != 0 || tile.y.last != 1 || tile.z.first != 0 || tile.z.last != 1;
+}
+
+// Vrai si les bornes des blocs ne sont pas le decoupage regulier (decoupage personnalise ou pondere par un cout)
+static bool hasCustomShape(size_t idf)
+{
+  size_t nBlocks = csParallelTask::getBlockNumber(idf);
+  vector<CSPARGS> args = csParallelTask::getArgs(idf);
+  BUFFER_SHAPE regular = csParallelTask::makeRegularBufferShape(csParallelTask::getWorkSize(idf), nBlocks);
+  bool custom = false;
+  for(size_t i=0; i<nBlocks && !custom; i++)
+  {
+    CSPARGS::BOUNDS b = args[i].getBounds();
+    custom = b.first != regular[i].first || b.last != regular[i].last;
+  }
+  free(regular);
+  return custom;
+}
+
+// Temps d'une execution complete, blocs en arriere-plan compris
+static double timeExecution(size_t idf)
+{
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+  csParallelTask::execute((int)idf);
+  csParallelTask::getBackgroundExecution(idf).wait();
+  return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+}
+
+CSTUNE_ENTRY CS_PARALLEL_TASK_API csParallelTask::tuneFunction(size_t idf, size_t repetitions, size_t maxBlocks)
+{
+  initTuning();
+  CSTUNE_ENTRY best = {string(), 0, 0, CSSCHEDULE_STATIC, 0, 0.0};
+  if (!isRegistered(idf))
+  {
+    cout<<"invalid function id !\n";
+    return best;
+  }
+  if (isTiled(idf))
+  {
+    cout<<"cannot tune a tiled function !\n";
+    return best;
+  }
+  repetitions = max((size_t)1, repetitions);
+
+  size_t workSize = getWorkSize(idf);
+  size_t nBlocks = getBlockNumber(idf);
+
+  // Par defaut, jamais plus de blocs qu'a l'enregistrement : l'appelant a pu dimensionner des tampons par bloc (CSREDUCTION...).
+  // Au-dela, sur demande, c'est a l'appelant de les redimensionner. Un decoupage non regulier est garde tel quel : seul le mode est essaye
+  vector<size_t> counts;
+  if (hasCustomShape(idf))
+    counts.push_back(nBlocks);
+  else
+  {
+    size_t limit = maxBlocks > nBlocks ? getSafeThreadNumber(maxBlocks) : nBlocks;
+    for(size_t n=1; n<limit; n*=2)
+      counts.push_back(n);
+    counts.push_back(limit);
+  }
+
+  // Configurations essayees : (blocs, mode, morceau)
+  vector<tuple<size_t, int, size_t>> configs;
+  for(size_t n : counts)
+  {
+    configs.push_back(make_tuple(n, CSSCHEDULE_STATIC, (size_t)0));
+    if (n == 1)
+      continue;
+    size_t previous = 0;
+    for(size_t div : {4, 16, 64})
+    {
+      size_t chunk = max((size_t)1, workSize/(n*div));
+      if (chunk != previous)
+        configs.push_back(make_tuple(n, CSSCHEDULE_DYNAMIC, chunk));
+      previous = chunk;
+    }
+    configs.push_back(make_tuple(n, CSSCHEDULE_WORK_STEALING, (size_t)0));
+  }
+
+  for(auto& c : configs)
+  {
+    setBlockNumber(idf, get<0>(c));
+    setSchedulingMode(idf, get<1>(c), get<2>(c));
+    timeExecution(idf);
+    double time = 0.0;
+    for(size_t r=0; r<repetitions; r++)
+    {
+      double t = timeExecution(idf);
+      time = r == 0 ? t : min(time, t);
+    }
+    if (best.nBlocks == 0 || time < best.time)
+    {
+      best.nBlocks = get<0>(c);
+      best.schedule = get<1>(c);
+      best.chunkSize = get<2>(c);
+      best.time = time;
+    }
+  }
+
+  setBlockNumber(idf, best.nBlocks);
+  setSchedulingMode(idf, best.schedule, best.chunkSize);
+  best.name = getFunctionName(idf);
+  best.sizeBucket = getSizeBucket(workSize);
+  PROFILE[{best.name, best.sizeBucket}] = best;
+  return best;
+}
+
+bool CS_PARALLEL_TASK_API csParallelTask::loadTuningProfile(const char* path)
+{
+  initTuning();
+  return readProfile(path);
+}
+
+bool CS_PARALLEL_TASK_API csParallelTask::saveTuningProfile(const char* path)
+{
+  initTuning();
+  ofstream file(path ? path : "");
+  if (!file.is_open())
+  {
+    cout<<"cannot write tuning profile !\n";
+    return false;
+  }
+  file<<"# csParallelTask tuning profile ("<<getAvailableConcurrency()<<" threads)\n";
+  file<<"# bucket nBlocks schedule chunkSize timeNs name\n";
+  for(auto& p : PROFILE)
+  {
+    const CSTUNE_ENTRY& e = p.second;
+    file<<e.sizeBucket<<" "<<e.nBlocks<<" "<<e.schedule<<" "<<e.chunkSize<<" "<<(size_t)e.time<<" "<<e.name<<"\n";
+  }
+  return file.good();
+}
+
+vector<CSTUNE_ENTRY> CS_PARALLEL_TASK_API csParallelTask::getTuningProfile()
+{
+  initTuning();
+  vector<CSTUNE_ENTRY> entries;
+  for(auto& p : PROFILE)
+    entries.push_back(p.second);
+  return entries;
+}
+
+void CS_PARALLEL_TASK_API csParallelTask::clearTuningProfile()
+{
+  initTuning();
+  PROFILE.clear();
+}
+
+bool CS_PARALLEL_TASK_API csParallelTask::applyTuningProfile(size_t idf)
+{
+  initTuning();
+  if (PROFILE.empty() || !isRegistered(idf))
+    return false;
+  const CSTUNE_ENTRY* e = findEntry(idf);
+  if (!e)
+    return false;
+  // Le nombre de blocs ne fait que baisser, et jamais sur un decoupage non regulier ni sur des tuiles
+  if (e->nBlocks < getBlockNumber(idf) && !isTiled(idf) && !hasCustomShape(idf))
+    setBlockNumber(idf, e->nBlocks);
+  setSchedulingMode(idf, e->schedule, e->chunkSize);
+  return true;
+}
@@ -12,6 +12,8 @@
 #include "csPargs.h"
 #include "csParallel.h"
 #include "csPerfChecker.h"
+#include "csReduction.h"
+#include "csSort.h"
 
 using namespace std;
 using namespace csParallelTask;
@@ -24,14 +26,13 @@ const int    UNIT = CSTIME_UNIT_MICROSECOND;
 
 static void kernel_sum(CSPARGS args) {
     double* data = args.getArgPtr<double>(0);
-    double* global_sum = args.getArgPtr<double>(1);
+    CSREDUCTION<double>* partial = args.getArgPtr<CSREDUCTION<double>>(1);
     auto b = args.getBounds();
     size_t first = b.first;
     size_t last  = b.last;
     double sum = 0.0;
     for (size_t i = first; i < last; i++) sum += data[i];
-    args.lockGuard();
-    *global_sum += sum;
+    partial->accumulate(args.getBlockId(), sum);
 }
 
 static void kernel_scale(CSPARGS args) {
@@ -46,41 +47,38 @@ static void kernel_scale(CSPARGS args) {
 
 static void kernel_min(CSPARGS args) {
     double* data = args.getArgPtr<double>(0);
-    double* global_min = args.getArgPtr<double>(1);
+    CSREDUCTION<double>* partial = args.getArgPtr<CSREDUCTION<double>>(1);
     auto b = args.getBounds();
     size_t first = b.first;
     size_t last  = b.last;
     double m = data[first];
     for (size_t i = first + 1; i < last; i++)
         if (data[i] < m) m = data[i];
-    args.lockGuard();
-    if (m < *global_min) *global_min = m;
+    partial->accumulate(args.getBlockId(), m);
 }
 
 static void kernel_max(CSPARGS args) {
     double* data = args.getArgPtr<double>(0);
-    double* global_max = args.getArgPtr<double>(1);
+    CSREDUCTION<double>* partial = args.getArgPtr<CSREDUCTION<double>>(1);
     auto b = args.getBounds();
     size_t first = b.first;
     size_t last  = b.last;
     double m = data[first];
     for (size_t i = first + 1; i < last; i++)
         if (data[i] > m) m = data[i];
-    args.lockGuard();
-    if (m > *global_max) *global_max = m;
+    partial->accumulate(args.getBlockId(), m);
 }
 
 static void kernel_dot(CSPARGS args) {
     double* a = args.getArgPtr<double>(0);
     double* b = args.getArgPtr<double>(1);
-    double* global_dot = args.getArgPtr<double>(2);
+    CSREDUCTION<double>* partial = args.getArgPtr<CSREDUCTION<double>>(2);
     auto r = args.getBounds();
     size_t first = r.first;
     size_t last  = r.last;
     double sum = 0.0;
     for (size_t i = first; i < last; i++) sum += a[i] * b[i];
-    args.lockGuard();
-    *global_dot += sum;
+    partial->accumulate(args.getBlockId(), sum);
 }
 
 static void kernel_fill(CSPARGS args) {
@@ -95,14 +93,13 @@ static void kernel_fill(CSPARGS args) {
 
 static void kernel_sqsum(CSPARGS args) {
     double* data = args.getArgPtr<double>(0);
-    double* global_sum = args.getArgPtr<double>(1);
+    CSREDUCTION<double>* partial = args.getArgPtr<CSREDUCTION<double>>(1);
     auto b = args.getBounds();
     size_t first = b.first;
     size_t last  = b.last;
     double sum = 0.0;
     for (size_t i = first; i < last; i++) { double x = data[i]; sum += x * x; }
-    args.lockGuard();
-    *global_sum += sum;
+    partial->accumulate(args.getBlockId(), sum);
 }
 
 static void kernel_axpy(CSPARGS args) {
@@ -192,10 +189,13 @@ int main() {
     perf.stop();
     size_t t_sum_seq = perf.getEllapsedTime();
 
+    CSREDUCTION<double> red_sum;
     size_t id_sum = registerFunctionRegularEx(nThreads, N, "sum", kernel_sum,
-        data.data(), &sum_par);
+        data.data(), &red_sum);
+    red_sum.init(getBlockNumber(id_sum), 0.0, csReduceSum<double>);
     perf.start();
     execute(id_sum);
+    sum_par = red_sum.combine();
     perf.stop();
     size_t t_sum_par = perf.getEllapsedTime();
 
@@ -233,10 +233,13 @@ int main() {
     perf.stop();
     size_t t_min_seq = perf.getEllapsedTime();
 
+    CSREDUCTION<double> red_min;
     size_t id_min = registerFunctionRegularEx(nThreads, N, "min", kernel_min,
-        data.data(), &min_par);
+        data.data(), &red_min);
+    red_min.init(getBlockNumber(id_min), min_par, csReduceMin<double>);
     perf.start();
     execute(id_min);
+    min_par = red_min.combine();
     perf.stop();
     size_t t_min_par = perf.getEllapsedTime();
 
@@ -251,10 +254,13 @@ int main() {
     perf.stop();
     size_t t_max_seq = perf.getEllapsedTime();
 
+    CSREDUCTION<double> red_max;
     size_t id_max = registerFunctionRegularEx(nThreads, N, "max", kernel_max,
-        data.data(), &max_par);
+        data.data(), &red_max);
+    red_max.init(getBlockNumber(id_max), max_par, csReduceMax<double>);
     perf.start();
     execute(id_max);
+    max_par = red_max.combine();
     perf.stop();
     size_t t_max_par = perf.getEllapsedTime();
 
@@ -269,10 +275,13 @@ int main() {
     perf.stop();
     size_t t_dot_seq = perf.getEllapsedTime();
 
+    CSREDUCTION<double> red_dot;
     size_t id_dot = registerFunctionRegularEx(nThreads, N, "dot", kernel_dot,
-        data.data(), data2.data(), &dot_par);
+        data.data(), data2.data(), &red_dot);
+    red_dot.init(getBlockNumber(id_dot), 0.0, csReduceSum<double>);
     perf.start();
     execute(id_dot);
+    dot_par = red_dot.combine();
     perf.stop();
     size_t t_dot_par = perf.getEllapsedTime();
 
@@ -308,13 +317,15 @@ int main() {
     perf.stop();
     size_t t_norm_seq = perf.getEllapsedTime();
 
+    CSREDUCTION<double> red_sq;
     size_t id_sq = registerFunctionRegularEx(nThreads, N, "sqsum", kernel_sqsum,
-        data.data(), &norm_par);
+        data.data(), &red_sq);
+    red_sq.init(getBlockNumber(id_sq), 0.0, csReduceSum<double>);
     perf.start();
     execute(id_sq);
+    norm_par = sqrt(red_sq.combine());
     perf.stop();
     size_t t_sq_par = perf.getEllapsedTime();
-    norm_par = sqrt(norm_par);
 
     cout << "  norm (seq) = " << norm_seq << "  norm (par) = " << norm_par << "\n";
     print_perf("Temps seq", t_norm_seq, "Temps par", t_sq_par);
@@ -334,21 +345,25 @@ int main() {
     size_t N2 = N / 2;
     vector<double> small(N2, 1.0);
     double sum_small = 0.0;
+    CSREDUCTION<double> red_small;
     size_t id_resize = registerFunctionRegularEx(nThreads, N2, "sum_resize", kernel_sum,
-        small.data(), &sum_small);
+        small.data(), &red_small);
+    red_small.init(getBlockNumber(id_resize), 0.0, csReduceSum<double>);
 
     perf.start();
     execute(id_resize);
+    sum_small = red_small.combine();
     perf.stop();
     size_t t1 = perf.getEllapsedTime();
     cout << "  sum(small, N/2) = " << sum_small << "  temps: " << t1 << " us\n";
 
     setBufferShapeRegular(id_resize, N);
     small.resize(N, 1.0);
-    sum_small = 0.0;
-    updateArg(id_resize, {0, 1}, {small.data(), &sum_small});
+    red_small.init(getBlockNumber(id_resize), 0.0, csReduceSum<double>);
+    updateArg(id_resize, {0, 1}, {small.data(), &red_small});
     perf.start();
     execute(id_resize);
+    sum_small = red_small.combine();
     perf.stop();
     size_t t2 = perf.getEllapsedTime();
     cout << "  sum(small, N)   = " << sum_small << "  temps: " << t2 << " us (apres setBufferShapeRegular + updateArg)\n";
@@ -375,6 +390,49 @@ int main() {
     cout << "  axpy - y[0] (seq) = " << y_axpy[0] << "  (par) = " << y_axpy2[0] << "\n";
     print_perf("Temps seq", t_axpy_seq, "Temps par", t_axpy_par);
 
+    // -------------------------------------------------------------------------
+    print_section("11. Tri par segments");
+    vector<double> keys(N);
+    mt19937_64 gen(42);
+    uniform_real_distribution<double> dist(-1.0, 1.0);
+    for (size_t i = 0; i < N; i++) keys[i] = dist(gen);
+    vector<double> keys_seq = keys;
+
+    perf.start();
+    sort(keys_seq.begin(), keys_seq.end());
+    perf.stop();
+    size_t t_sort_seq = perf.getEllapsedTime();
+
+    // Tri par echantillonnage : chaque segment de cles est trie par une tache, sans fusion finale
+    perf.start();
+    parallel_sort(keys.begin(), keys.end());
+    perf.stop();
+    size_t t_sort_par = perf.getEllapsedTime();
+
+    cout << "  trie : " << (keys == keys_seq ? "oui" : "non") << "  min = " << keys[0] << "  max = " << keys[N - 1] << "\n";
+    print_perf("Temps seq", t_sort_seq, "Temps par", t_sort_par);
+
+    // Cles tres repetees (90% de zeros) : les copies d'une meme cle sont reparties sur plusieurs seaux.
+    // Le tri stable doit garder l'ordre d'origine (second champ) des cles egales
+    vector<pair<int, size_t>> dups(N);
+    uniform_int_distribution<int> rare(1, 3);
+    for (size_t i = 0; i < N; i++) dups[i] = {gen() % 10 ? 0 : rare(gen), i};
+    vector<pair<int, size_t>> dups_seq = dups;
+    auto byKey = [](const pair<int, size_t>& a, const pair<int, size_t>& b) { return a.first < b.first; };
+
+    perf.start();
+    stable_sort(dups_seq.begin(), dups_seq.end(), byKey);
+    perf.stop();
+    t_sort_seq = perf.getEllapsedTime();
+
+    perf.start();
+    parallel_stable_sort(dups.begin(), dups.end(), byKey);
+    perf.stop();
+    t_sort_par = perf.getEllapsedTime();
+
+    cout << "  cles repetees, tri stable : " << (dups == dups_seq ? "oui" : "non") << "\n";
+    print_perf("Temps seq", t_sort_seq, "Temps par", t_sort_par);
+
     // Nettoyage final
     unregisterAll();
     cout << "\n  unregisterAll() appele - toutes les taches desenregistrees.\n";